@@ -651,6 +651,42 @@ static_fn int varname(const char *str, ssize_t n) {
     return n == 0;
 }
 
+//
+// Return the %T conversion of <t> with time <format>. Records printed in a loop usually repeat the
+// format and often the same second, so the last conversion is kept and reused as long as the time
+// zone and locale it was done for are unchanged.
+//
+static_fn char *fmtcachetmx(const char *format, Time_t t) {
+    static struct {
+        Time_t t;
+        uint32_t env;
+        uint32_t locale;
+        char *format;
+        char *result;
+    } last;
+    char *s;
+
+    if (last.result && last.t == t && last.env == ast.env_serial &&
+        last.locale == ast.locale.serial && strcmp(last.format, format ? format : "") == 0) {
+        return last.result;
+    }
+    s = fmttmx(format, t);
+    free(last.format);
+    free(last.result);
+    last.format = strdup(format ? format : "");
+    last.result = strdup(s);
+    if (!last.format || !last.result) {
+        free(last.format);
+        free(last.result);
+        last.format = last.result = NULL;
+        return s;
+    }
+    last.t = t;
+    last.env = ast.env_serial;
+    last.locale = ast.locale.serial;
+    return last.result;
+}
+
 static_fn const char *mapformat(Sffmt_t *fe) {
     const struct printmap *pm = Pmap;
     while (pm->size > 0) {
@@ -1015,10 +1051,10 @@ static_fn int extend(Sfio_t *sp, void *v, Sffmt_t *fe) {
             if (fe->n_str > 0) {
                 n = fe->t_str[fe->n_str];
                 fe->t_str[fe->n_str] = 0;
-                value->s = fmttmx(fe->t_str, value->ll);
+                value->s = fmtcachetmx(fe->t_str, value->ll);
                 fe->t_str[fe->n_str] = n;
             } else {
-                value->s = fmttmx(NULL, value->ll);
+                value->s = fmtcachetmx(NULL, value->ll);
             }
             fe->fmt = 's';
             fe->size = -1;
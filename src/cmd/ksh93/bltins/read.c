@@ -18,7 +18,7 @@
  *                                                                      *
  ***********************************************************************/
 //
-// read [-ACprs] [-q format] [-d delim] [-u filenum] [-t timeout] [-n n] [-N n] [name...]
+// read [-ACprs] [-q format] [-d delim] [-u filenum] [-t timeout] [-n n] [-N n] [-L n] [name...]
 //
 //   David Korn
 //   AT&T Labs
@@ -59,8 +59,9 @@
 #define NN_FLAG 0x10  // fixed size read exact
 #define V_FLAG 0x20   // use default value
 #define C_FLAG 0x40   // read into compound variable
-#define D_FLAG 8      // must be number of bits for all flags
+#define D_FLAG 9      // must be number of bits for all flags
 #define SS_FLAG 0x80  // read .csv format file
+#define L_FLAG 0x100  // read records into array
 
 struct read_save {
     char **argv;
@@ -200,6 +201,8 @@ static_fn int json2sh(Shell_t *shp, Sfio_t *in, Sfio_t *out) {
 }
 #endif
 
+static_fn int readbatch(Shell_t *, const char *, int, int, ssize_t, long);
+
 static struct Method methods[] = {
 #if SUPPORT_JSON
     {"json", json2sh},
@@ -233,6 +236,7 @@ int b_read(int argc, char *argv[], Shbltin_t *context) {
         argv = rp->argv;
         name = rp->prompt;
         mindex = rp->mindex;
+        len = rp->len;
         r = rp->plen;
         goto bypass;
     }
@@ -287,11 +291,17 @@ int b_read(int argc, char *argv[], Shbltin_t *context) {
 #endif
             case 'n':
             case 'N': {
-                flags &= ((1 << D_FLAG) - 1);
+                flags &= ((1 << D_FLAG) - 1) & ~L_FLAG;
                 flags |= (r == 'n' ? N_FLAG : NN_FLAG);
                 len = opt_info.num;
                 break;
             }
+            case 'L': {
+                flags &= ~(N_FLAG | NN_FLAG);
+                flags |= L_FLAG;
+                len = opt_info.num;
+                break;
+            }
             case 'r': {
                 flags |= R_FLAG;
                 break;
@@ -395,6 +405,7 @@ bypass:
         sfwrite(sfstderr, shp->prompt, r - 1);
     }
     shp->timeout = 0;
+    if (flags & L_FLAG) return readbatch(shp, argv[0], fd, flags, len, timeout);
     save_prompt = shp->nextprompt;
     shp->nextprompt = 0;
     readfn = (flags & C_FLAG) ? methods[mindex].fun : 0;
@@ -421,6 +432,90 @@ static_fn void timedout(void *handle) {
     sh_exit(tp->shp, 1);
 }
 
+//
+// Read up to <count> records from <fd> into the indexed array <name>, one record per element.
+// The variable is looked up once and each record is assigned straight from the sfio buffer.
+// Returns 0 if at least one record was read.
+//
+static_fn int readbatch(Shell_t *shp, const char *name, int fd, int flags, ssize_t count,
+                        long timeout) {
+    Sfio_t *iop;
+    Namval_t *np;
+    Namarr_t *ap;
+    char *cp;
+    char *val;
+    size_t c;
+    long n = 0;
+    int delim = (flags >> D_FLAG) ? (int)(((unsigned)flags) >> (D_FLAG + 1)) : '\n';
+    int jmpval = 0;
+    bool was_write;
+    bool was_share = true;
+    bool pushed = timeout || (shp->fdstatus[fd] & (IOTTY | IONOSEEK));
+    Timer_t *timeslot = NULL;
+    checkpt_t buff;
+
+    if (!(iop = shp->sftable[fd]) && !(iop = sh_iostream(shp, fd, fd))) return 1;
+    sh_stats(STAT_READS);
+    if (name) {
+        if ((val = strchr(name, '?'))) *val = 0;
+        np = nv_open(name, shp->var_tree, NV_ASSIGN | NV_VARNAME);
+        if (val) *val = '?';
+    } else if (dtvnext(shp->var_tree) || shp->namespace) {
+        np = nv_open(nv_name(REPLYNOD), shp->var_tree, 0);
+    } else {
+        np = REPLYNOD;
+    }
+    if (nv_isattr(np, NV_RDONLY)) {
+        errormsg(SH_DICT, ERROR_warn(0), e_readonly, nv_name(np));
+        nv_close(np);
+        return 1;
+    }
+    if ((ap = nv_arrayptr(np)) && !ap->fun) ap->nelem++;
+    nv_unset(np);
+    if ((ap = nv_arrayptr(np)) && !ap->fun) ap->nelem--;
+    nv_putsub(np, NULL, 0L, 0);
+    memset(&buff, 0, sizeof(buff));
+    sfclrerr(iop);
+    was_write = (sfset(iop, SF_WRITE, 0) & SF_WRITE) != 0;
+    if (sffileno(iop) == 0) was_share = (sfset(iop, SF_SHARE, shp->redir0 != 2) & SF_SHARE) != 0;
+    if (pushed) {
+        sh_pushcontext(shp, &buff, 1);
+        jmpval = sigsetjmp(buff.buff, 0);
+        if (jmpval) goto done;
+        if (timeout) {
+            static struct timeout tmout;
+            tmout.shp = shp;
+            tmout.iop = iop;
+            timeslot = sh_timeradd(timeout, 0, timedout, &tmout);
+        }
+    }
+    while (n < count) {
+        if (n) nv_putsub(np, NULL, n, 0);
+        if ((cp = sfgetr(iop, delim, SF_STRING))) {
+            nv_putval(np, cp, 0);
+        } else if ((cp = sfgetr(iop, delim, SF_LASTR))) {
+            // The final record has no delimiter to overwrite with a null byte.
+            c = stktell(shp->stk);
+            sfwrite(shp->stk, cp, sfvalue(iop));
+            sfputc(shp->stk, 0);
+            nv_putval(np, stkptr(shp->stk, c), 0);
+            stkseek(shp->stk, c);
+        } else {
+            break;
+        }
+        n++;
+    }
+    if (timeslot) timerdel(timeslot);
+
+done:
+    if (pushed) sh_popcontext(shp, &buff);
+    if (was_write) sfset(iop, SF_WRITE, 1);
+    if (!was_share) sfset(iop, SF_SHARE, 0);
+    nv_close(np);
+    if (jmpval > 1) siglongjmp(shp->jmplist->buff, jmpval);
+    return jmpval || n == 0;
+}
+
 //
 // This is the code to read a line and to split it into tokens.
 // <names> is an array of variable names.
@@ -625,6 +625,8 @@ static_fn int setall(char **argv, nvflag_t flag, Dt_t *troot, struct tdata *tp)
                         np = nv_open(name, sh_subfuntree(shp, 1),
                                      NV_NOARRAY | NV_IDENT | NV_NOSCOPE);
                     }
+                    path_cmdflush();
+                    sh_arithflush();
                 } else {
                     if (shp->prefix) {
                         sfprintf(shp->strbuf, "%s.%s%c", shp->prefix, name, 0);
@@ -671,6 +673,7 @@ static_fn int setall(char **argv, nvflag_t flag, Dt_t *troot, struct tdata *tp)
             if (troot == shp->track_tree && tp->aflag == '-') {
                 np = nv_search(name, troot, NV_ADD);
                 path_alias(np, path_absolute(shp, nv_name(np), NULL));
+                path_cmdflush();
                 continue;
             }
             if (shp->nodelist && (len = strlen(name)) && name[len - 1] == '@') {
@@ -1207,6 +1210,8 @@ static_fn int unall(int argc, char **argv, Dt_t *troot, Shell_t *shp) {
         nvflags |= NV_VARNAME;
     } else {
         nvflags = NV_NOSCOPE;
+        path_cmdflush();
+        sh_arithflush();
     }
     if (all) {
         dtclear(troot);
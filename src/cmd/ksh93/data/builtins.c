@@ -1251,6 +1251,10 @@ const char sh_optread[] =
     "is the number of bytes.]"
     "[N]#[count?Read exactly \ancount\a characters.  For binary fields \acount\a "
     "is the number of bytes.]"
+    "[L]#[count?Unset \avar\a and read up to \acount\a records into the indexed "
+    "array \avar\a, one record per element starting at index 0.  The records "
+    "are not split into fields and \b\\\b is not treated specially.  The exit "
+    "status is zero if at least one record was read.]"
     "[v?When reading from a terminal the value of the first variable is displayed "
     "and used as a default value.]"
     "\n"
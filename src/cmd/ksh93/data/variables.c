@@ -130,16 +130,23 @@ const Shtable_t shtab_siginfo[] = {
 
 const Shtable_t shtab_stats[] = {{"arg_cachehits", NV_RDONLY | NV_MINIMAL | NV_NOFREE | NV_INTEGER},
                                  {"arg_expands", NV_RDONLY | NV_MINIMAL | NV_NOFREE | NV_INTEGER},
+                                 {"arith_cachehit", NV_RDONLY | NV_MINIMAL | NV_NOFREE | NV_INTEGER},
+                                 {"arith_cachemiss", NV_RDONLY | NV_MINIMAL | NV_NOFREE | NV_INTEGER},
+                                 {"cmd_cachehit", NV_RDONLY | NV_MINIMAL | NV_NOFREE | NV_INTEGER},
                                  {"comsubs", NV_RDONLY | NV_MINIMAL | NV_NOFREE | NV_INTEGER},
                                  {"forks", NV_RDONLY | NV_MINIMAL | NV_NOFREE | NV_INTEGER},
                                  {"funcalls", NV_RDONLY | NV_MINIMAL | NV_NOFREE | NV_INTEGER},
                                  {"globs", NV_RDONLY | NV_MINIMAL | NV_NOFREE | NV_INTEGER},
+                                 {"globs_nostat", NV_RDONLY | NV_MINIMAL | NV_NOFREE | NV_INTEGER},
                                  {"linesread", NV_RDONLY | NV_MINIMAL | NV_NOFREE | NV_INTEGER},
                                  {"nv_cachehit", NV_RDONLY | NV_MINIMAL | NV_NOFREE | NV_INTEGER},
+                                 {"nv_cachemiss", NV_RDONLY | NV_MINIMAL | NV_NOFREE | NV_INTEGER},
                                  {"nv_opens", NV_RDONLY | NV_MINIMAL | NV_NOFREE | NV_INTEGER},
                                  {"pathsearch", NV_RDONLY | NV_MINIMAL | NV_NOFREE | NV_INTEGER},
                                  {"posixfuncall", NV_RDONLY | NV_MINIMAL | NV_NOFREE | NV_INTEGER},
+                                 {"scope_cachehit", NV_RDONLY | NV_MINIMAL | NV_NOFREE | NV_INTEGER},
                                  {"simplecmds", NV_RDONLY | NV_MINIMAL | NV_NOFREE | NV_INTEGER},
                                  {"spawns", NV_RDONLY | NV_MINIMAL | NV_NOFREE | NV_INTEGER},
                                  {"subshell", NV_RDONLY | NV_MINIMAL | NV_NOFREE | NV_INTEGER},
+                                 {"subshell_saves", NV_RDONLY | NV_MINIMAL | NV_NOFREE | NV_INTEGER},
                                  {"", 0}};
@@ -31,6 +31,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <time.h>
 #include <unistd.h>
@@ -61,6 +62,7 @@ static History_t *hist_trim(History_t *, int);
 static int hist_nearend(History_t *, Sfio_t *, off_t);
 static int hist_check(int);
 static int hist_clean(int);
+static int hist_matchbuf(char *, int, const char *, int *);
 #ifdef SF_BUFCONST
 static ssize_t hist_write(Sfio_t *, const void *, size_t, Sfdisc_t *);
 static int hist_exceptf(Sfio_t *, int, void *, Sfdisc_t *);
@@ -736,6 +738,9 @@ Histloc_t hist_find(History_t *hp, char *string, int index1, int flag, int direc
     off_t offset;
     int *coffset = NULL;
     Histloc_t location;
+    struct stat statb;
+    char *map = NULL;
+    size_t size = 0;
 
     location.hist_command = -1;
     location.hist_char = 0;
@@ -760,16 +765,33 @@ Histloc_t hist_find(History_t *hp, char *string, int index1, int flag, int direc
     } else if (index1 >= index2) {
         return location;
     }
+    // Search the commands in place in a mapping of the history file rather than seeking and
+    // reading the file for each one.
+    sfsync(hp->histfp);
+    if (fstat(sffileno(hp->histfp), &statb) >= 0 && statb.st_size > 0) size = statb.st_size;
+    if (size) {
+        map = mmap(NULL, size, PROT_READ, MAP_SHARED, sffileno(hp->histfp), 0);
+        if (map == MAP_FAILED) map = NULL;
+    }
     while (index1 != index2) {
         direction > 0 ? ++index1 : --index1;
         offset = hist_tell(hp, index1);
-        if ((location.hist_line = hist_match(hp, offset, string, coffset)) >= 0) {
+        if (map && offset >= 0 && offset < size) {
+            char *cp = map + offset;
+            char *ep = memchr(cp, 0, size - offset);
+            location.hist_line = ep ? hist_matchbuf(cp, ep + 1 - cp, string, coffset)
+                                    : hist_match(hp, offset, string, coffset);
+        } else {
+            location.hist_line = hist_match(hp, offset, string, coffset);
+        }
+        if (location.hist_line >= 0) {
             location.hist_command = index1;
-            return location;
+            break;
         }
         // Allow a search to be aborted.
         if (hp->histshell->trapnote & SH_SIGSET) break;
     }
+    if (map) munmap(map, size);
     return location;
 }
 
@@ -780,14 +802,36 @@ Histloc_t hist_find(History_t *hp, char *string, int index1, int flag, int direc
 // Returns the line number of the match if successful, otherwise -1.
 //
 int hist_match(History_t *hp, off_t offset, char *string, int *coffset) {
-    char *first, *cp;
-    int m, n, c = 1, line = 0;
+    char *first;
 
     sfseek(hp->histfp, offset, SEEK_SET);
-    cp = first = sfgetr(hp->histfp, 0, 0);
-    if (!cp) return -1;
-    m = sfvalue(hp->histfp);
-    n = (int)strlen(string);
+    first = sfgetr(hp->histfp, 0, 0);
+    if (!first) return -1;
+    return hist_matchbuf(first, sfvalue(hp->histfp), string, coffset);
+}
+
+//
+// Search for <string> in the <m> byte command at <first>, including its terminating null.
+//
+static int hist_matchbuf(char *first, int m, const char *string, int *coffset) {
+    char *cp = first, *last;
+    int n = (int)strlen(string), c = 1, line = 0;
+
+    if (coffset && !mbwide()) {
+        // Skip to the candidates and only count the lines before a match.
+        last = first + m - n;
+        while (cp < last && (cp = memchr(cp, *string, last - cp))) {
+            if (strncmp(cp, string, n) == 0) {
+                *coffset = (cp - first);
+                for (; first < cp; first++) {
+                    if (*first == '\n') line++;
+                }
+                return line;
+            }
+            cp++;
+        }
+        return -1;
+    }
     while (m > n) {
         if (*cp == *string && strncmp(cp, string, n) == 0) {
             if (coffset) *coffset = (cp - first);
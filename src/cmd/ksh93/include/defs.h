@@ -241,6 +241,8 @@ extern char **sh_envgen(Shell_t *);
 extern void sh_envnolocal(Namval_t *, void *);
 extern Sfdouble_t sh_arith(Shell_t *, const char *);
 extern void *sh_arithcomp(Shell_t *, char *);
+extern Sfdouble_t sh_arithcache(Shell_t *, const char *);
+extern void sh_arithflush(void);
 extern pid_t sh_fork(Shell_t *, int, int *);
 extern pid_t _sh_fork(Shell_t *, pid_t, int, int *);
 extern char *sh_mactrim(Shell_t *, char *, int);
@@ -335,18 +337,25 @@ extern const char e_dict[];
 // Performance statistics.
 #define STAT_ARGHITS 0
 #define STAT_ARGEXPAND 1
-#define STAT_COMSUB 2
-#define STAT_FORKS 3
-#define STAT_FUNCT 4
-#define STAT_GLOBS 5
-#define STAT_READS 6
-#define STAT_NVHITS 7
-#define STAT_NVOPEN 8
-#define STAT_PATHS 9
-// #define STAT_SVFUNCT 10
-#define STAT_SCMDS 11
-#define STAT_SPAWN 12
-#define STAT_SUBSHELL 13
+#define STAT_ARITHHITS 2
+#define STAT_ARITHMISSES 3
+#define STAT_CMDHITS 4
+#define STAT_COMSUB 5
+#define STAT_FORKS 6
+#define STAT_FUNCT 7
+#define STAT_GLOBS 8
+#define STAT_GLOBNOSTAT 9
+#define STAT_READS 10
+#define STAT_NVHITS 11
+#define STAT_NVMISSES 12
+#define STAT_NVOPEN 13
+#define STAT_PATHS 14
+// #define STAT_SVFUNCT 15
+#define STAT_SCOPEHITS 16
+#define STAT_SCMDS 17
+#define STAT_SPAWN 18
+#define STAT_SUBSHELL 19
+#define STAT_SUBSAVES 20
 extern const Shtable_t shtab_stats[];
 #define sh_stats(x) (shgd->stats[(x)]++)
 extern const Shtable_t shtab_siginfo[];
@@ -56,6 +56,7 @@ struct pathcomp {
     unsigned short len;
     unsigned short flags;
     Shell_t *shp;
+    struct pathindex *index;  // entries of an absolute $PATH directory
 };
 
 #ifndef ARG_RAW
@@ -77,6 +78,9 @@ extern char *path_fullname(Shell_t *, const char *);
 extern int path_expand(Shell_t *, const char *, struct argnod **);
 extern void path_exec(Shell_t *, const char *, char *[], struct argnod *);
 extern pid_t path_spawn(Shell_t *, const char *, char *[], char *[], Pathcomp_t *, int);
+#if !USE_SPAWN && _lib_posix_spawn
+extern pid_t path_fastspawn(Shell_t *, const char *, char *[], char *[]);
+#endif
 extern int path_open(Shell_t *, const char *, Pathcomp_t *);
 extern Pathcomp_t *path_get(Shell_t *, const char *);
 extern char *path_pwd(Shell_t *);
@@ -85,6 +89,11 @@ extern bool path_search(Shell_t *, const char *, Pathcomp_t **, int);
 extern char *path_relative(Shell_t *, const char *);
 extern int path_complete(Shell_t *, const char *, const char *, struct argnod **);
 extern int path_generate(Shell_t *, struct argnod *, struct argnod **);
+extern bool path_cmdget(Shell_t *, const char *, Namval_t **, const char **);
+extern void path_cmdput(Shell_t *, const char *, Namval_t *, const char *);
+extern void path_cmdflush(void);
+extern unsigned int path_cmdgen(void);
+extern void path_indexflush(void);
 
 // Builtin/plugin routines.
 extern int sh_addlib(Shell_t *, void *, char *, Pathcomp_t *);
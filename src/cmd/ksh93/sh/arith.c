@@ -111,6 +111,16 @@ static const struct Mathconst Mtable[] = {
     {"PI_4", M_PI_4l}, {"SQRT2", M_SQRT2l}, {"SQRT1_2", M_SQRT1_2l},
     {"", 0.0}};
 
+//
+// Return true if `np` is a plain set `typeset -i` or `integer` variable with no disciplines, array,
+// reference, export or readonly attribute. The value of such a variable can be read and written
+// directly through its int32 or int64 slot without going through nv_getnum() and nv_putval().
+//
+static_fn bool arith_isint(Namval_t *np) {
+    if (np->nvfun || nv_isattr(np, ~(NV_NOFREE | NV_LONG)) != NV_INTEGER) return false;
+    return FETCH_VT(np->nvalue, const_cp) && FETCH_VT(np->nvalue, const_cp) != Empty;
+}
+
 static_fn Namval_t *scope(Namval_t *np, struct lval *lvalue, int assign) {
     int flag = lvalue->flag;
     char *sub = 0, *cp = (char *)np;
@@ -306,6 +316,23 @@ static_fn Sfdouble_t arith(const char **ptr, struct lval *lvalue, int type, Sfdo
         case ASSIGN: {
             Namval_t *np = (Namval_t *)(lvalue->value);
             np = scope(np, lvalue, 1);
+            if (arith_isint(np)) {
+                // This mirrors what nv_putval() does for these variables.
+                shp->argaddr = NULL;
+                if (shp->subshell) np = sh_assignok(np, 1);
+                if (arith_isint(np)) {
+                    if (nv_isattr(np, NV_LONG)) {
+                        r = *FETCH_VT(np->nvalue, i64p) = (Sflong_t)n;
+                    } else {
+                        if (nv_size(np) <= 1) nv_setsize(np, 10);
+                        r = *FETCH_VT(np->nvalue, i32p) = (int32_t)(Sflong_t)n;
+                    }
+                    if (lvalue->eflag) lvalue->ptr = NULL;
+                    lvalue->eflag = 0;
+                    lvalue->value = (char *)np;
+                    break;
+                }
+            }
             nv_putval(np, (char *)&n, NV_LDOUBLE);
             if (lvalue->eflag) lvalue->ptr = nv_hasdisc(np, &ENUM_disc);
             lvalue->eflag = 0;
@@ -503,6 +530,10 @@ static_fn Sfdouble_t arith(const char **ptr, struct lval *lvalue, int type, Sfdo
                 if (nv_isattr(node, NV_NOFREE)) return nv_getnum(node);
             }
             lvalue->eflag = 0;
+            if (!shp->argaddr && arith_isint(np)) {
+                if (nv_isattr(np, NV_LONG)) return *FETCH_VT(np->nvalue, i64p);
+                return *FETCH_VT(np->nvalue, i32p);
+            }
             if (((lvalue->emode & 2) || lvalue->level > 1 ||
                  (lvalue->nextop != A_STORE && sh_isoption(shp, SH_NOUNSET))) &&
                 nv_isnull(np) && !nv_isattr(np, NV_INTEGER)) {
@@ -564,6 +595,101 @@ void *sh_arithcomp(Shell_t *shp, char *str) {
     return ep;
 }
 
+//
+// Arithmetic commands and expansions whose text contains expansions are expanded and evaluated
+// again each time they are run. This cache keeps the compiled form of recently expanded
+// expressions, keyed by the expanded text, so a loop body that produces the same text on every
+// iteration only compiles it once. The code is compiled with ARITH_COMP like that of a literal
+// `((...))` so that variables are looked up in the current scope when the code is executed.
+// Calls of .sh.math functions are compiled as pointers to the function nodes though, so the
+// entries compiled before a function is defined or deleted are not used again.
+//
+#define ARITH_CACHE 64       // must be a power of two
+#define ARITH_CACHEMAX 256  // longest expression that is cached
+
+static struct Arith_cache {
+    char *expr;
+    Arith_t *ep;
+    int busy;            // the code is being executed and can't be replaced
+    unsigned int serial;  // value of arith_serial when the code was compiled
+} arith_cache[ARITH_CACHE];
+
+static unsigned int arith_serial;
+
+// Called when a function is defined or deleted.
+void sh_arithflush(void) { arith_serial++; }
+
+//
+// Execute the code <ep> for the cache entry <xp>. An arithmetic error longjmps out of the code,
+// so the entry is released, and <expr> freed if it isn't null, before the jump is passed on.
+//
+static_fn Sfdouble_t arith_run(Shell_t *shp, struct Arith_cache *xp, Arith_t *ep, char *expr) {
+    checkpt_t buff;
+    int jmpval;
+    Sfdouble_t d = 0;
+
+    xp->busy++;
+    sh_pushcontext(shp, &buff, shp->jmplist->mode);
+    jmpval = sigsetjmp(buff.buff, 0);
+    if (jmpval == 0) d = arith_exec(ep);
+    sh_popcontext(shp, &buff);
+    xp->busy--;
+    free(expr);
+    if (jmpval) siglongjmp(shp->jmplist->buff, jmpval);
+    return d;
+}
+
+Sfdouble_t sh_arithcache(Shell_t *shp, const char *str) {
+    struct Arith_cache *xp;
+    Arith_t *ep, *copy;
+    Sfdouble_t d;
+    char *last, *sp = NULL, *expr;
+    const char *cp;
+    unsigned int h = 0;
+    size_t size;
+    int offset;
+
+    number(str, &last, shp->inarith ? 0 : 10, NULL);
+    if (!*last || (*last == '.' && last[1] == '.')) return sh_arith(shp, str);
+    for (cp = str; *cp; cp++) h = h * 33 + *(unsigned char *)cp;
+    if (cp - str > ARITH_CACHEMAX) return sh_arith(shp, str);
+    xp = &arith_cache[h & (ARITH_CACHE - 1)];
+    if (xp->ep && xp->serial == arith_serial && strcmp(xp->expr, str) == 0) {
+        sh_stats(STAT_ARITHHITS);
+        return arith_run(shp, xp, xp->ep, NULL);
+    }
+    sh_stats(STAT_ARITHMISSES);
+    // The compiled code points into the expression so it has to live as long as the code.
+    expr = strdup(str);
+    if (!expr) return sh_arith(shp, str);
+    offset = stktell(shp->stk);
+    if (offset) sp = stkfreeze(shp->stk, 1);
+    ep = arith_compile(shp, expr, &last, arith, ARITH_COMP | 1);
+    if (!ep || *last) {
+        // Let sh_arith() report the error.
+        if (ep || sp) stkset(shp->stk, sp ? sp : (char *)ep, offset);
+        free(expr);
+        return sh_arith(shp, str);
+    }
+    size = sizeof(Arith_t) + ep->size;
+    if (xp->busy || !(copy = malloc(size))) {
+        // Run the code from the stack without caching it.
+        d = arith_run(shp, xp, ep, expr);
+        stkset(shp->stk, sp ? sp : (char *)ep, offset);
+        return d;
+    }
+    if (xp->ep) {
+        free(xp->ep);
+        free(xp->expr);
+    }
+    xp->ep = memcpy(copy, ep, size);
+    xp->ep->code = (unsigned char *)(xp->ep + 1);
+    xp->expr = expr;
+    xp->serial = arith_serial;
+    stkset(shp->stk, sp ? sp : (char *)ep, offset);
+    return arith_run(shp, xp, xp->ep, NULL);
+}
+
 // Convert number defined by string to a Sfdouble_t.
 // Ptr is set to the last character processed.
 // If mode>0, an error will be fatal with value <mode>.
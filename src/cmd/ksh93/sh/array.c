@@ -47,6 +47,8 @@
 #define ARRAY_CHILD 1
 #define ARRAY_NOFREE 2
 #define ARRAY_UNSET 4
+// Lookups beyond the element count before an ordered associative table is hashed again.
+#define ASSOC_REHASH 32
 
 // Constants for the `nv_associative()` "op" parameter.
 const Nvassoc_op_t ASSOC_OP_INIT = {ASSOC_OP_INIT_val};
@@ -74,8 +76,30 @@ struct assoc_array {
     Namval_t *pos;
     Namval_t *nextpos;
     Namval_t *cur;
+    int lookups;  // subscript lookups since the table was last ordered
 };
 
+//
+// Associative array tables are hashed since nearly every access is a lookup by subscript. Walking
+// the subscripts needs them sorted, so the table is converted to an ordered set on demand and back
+// to a hash once lookups outnumber the elements again. Dictionaries in a view path must share a
+// method, so a table that views or is viewed by another one stays ordered.
+//
+static_fn void assoc_order(struct assoc_array *ap) {
+    Dt_t *dp;
+
+    for (dp = ap->namarr.table; dp; dp = dtvnext(dp)) dtmethod(dp, Dtoset);
+    ap->lookups = 0;
+}
+
+static_fn void assoc_lookup(struct assoc_array *ap) {
+    Dt_t *dp = ap->namarr.table;
+
+    if (dp->meth == Dtset || ap->pos || (ap->namarr.flags & ARRAY_SCAN)) return;
+    if (dtvnext(dp) || dp->nview) return;
+    if (++ap->lookups > ap->namarr.nelem + ASSOC_REHASH) dtmethod(dp, Dtset);
+}
+
 // Clone the index_array pointed to by `aq` and do what? What does the "scope" in the function name
 // imply?
 static_fn struct index_array *array_scope(Namval_t *np, struct index_array *aq, int flags) {
@@ -92,6 +116,7 @@ static_fn struct index_array *array_scope(Namval_t *np, struct index_array *aq,
         ar->namarr.namfun.nofree &= ~1;
     }
     if (is_associative(&ar->namarr)) {
+        assoc_order((struct assoc_array *)ar);
         ar->namarr.scope = dtopen(&_Nvdisc, Dtoset);
         dtuserdata(ar->namarr.scope, shp, 1);
         dtview(ar->namarr.scope, ar->namarr.table);
@@ -413,9 +438,10 @@ static_fn Namfun_t *array_clone(Namval_t *np, Namval_t *mp, nvflag_t flags, Namf
         shp->prev_root = shp->last_root;
     }
     if (ap->table) {
-        ap->table = dtopen(&_Nvdisc, Dtoset);
+        bool view = ap->scope && !(flags & NV_COMVAR);
+        ap->table = dtopen(&_Nvdisc, (is_associative(ap) && !view) ? Dtset : Dtoset);
         dtuserdata(ap->table, shp, 1);
-        if (ap->scope && !(flags & NV_COMVAR)) {
+        if (view) {
             ap->scope = ap->table;
             dtview(ap->table, otable->view);
         }
@@ -1216,7 +1242,7 @@ static_fn void *nv_assoc_op_init(Namval_t *np, const char *sp) {
     assert(!ap);
     ap = calloc(1, sizeof(struct assoc_array));
     assert(ap);
-    ap->namarr.table = dtopen(&_Nvdisc, Dtoset);
+    ap->namarr.table = dtopen(&_Nvdisc, Dtset);
     dtuserdata(ap->namarr.table, shp, 1);
     ap->cur = NULL;
     ap->pos = NULL;
@@ -1270,6 +1296,7 @@ static_fn void *nv_assoc_op_next(Namval_t *np, const char *sp) {
 
     assert(ap);
     if (!ap->pos) {
+        assoc_order(ap);
         if ((ap->namarr.flags & ARRAY_NOSCOPE) && ap->namarr.scope && dtvnext(ap->namarr.table)) {
             ap->namarr.scope = dtvnext(ap->namarr.table);
             ap->namarr.table->view = 0;
@@ -1333,6 +1360,7 @@ static_fn void *nv_assoc_op_add(Namval_t *np, const char *sp, bool add) {
         Namval_t *mp = NULL;
         ap->cur = NULL;
         if (sp == (char *)np) return NULL;
+        assoc_lookup(ap);
         nvflag_t type = nv_isattr(np, ~(NV_NOFREE | NV_ARRAY | NV_CHILD | NV_MINIMAL));
         nvflag_t mode = 0;
 
@@ -1366,6 +1394,7 @@ static_fn void *nv_assoc_op_add(Namval_t *np, const char *sp, bool add) {
             Namval_t fake;
             memset(&fake, 0, sizeof(fake));
             fake.nvname = (char *)sp;
+            assoc_order(ap);
             ap->pos = mp = dtprev(ap->namarr.table, &fake);
             ap->nextpos = dtnext(ap->namarr.table, mp);
         } else if (!mp && *sp && mode == 0) {
@@ -148,6 +148,7 @@ int path_expand(Shell_t *shp, const char *pattern, struct argnod **arghead) {
     suflen = 0;
     if (strncmp(pattern, "~(N", 3) == 0) flags &= ~GLOB_NOCHECK;
     ast_glob(pattern, flags, 0, gp);
+    shgd->stats[STAT_GLOBNOSTAT] += gp->gl_nostat;
 #if SHOPT_BASH
     if (off) {
         stkset(shp->stk, sp, off);
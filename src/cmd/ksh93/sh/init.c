@@ -283,6 +283,9 @@ static_fn void put_restricted(Namval_t *np, const void *val, nvflag_t flags, Nam
     }
     if (np == PATHNOD || (path_scoped = (strcmp(name, PATHNOD->nvname) == 0))) {
         nv_scan(shp->track_tree, rehash, NULL, NV_TAGGED, NV_TAGGED);
+        // Commands are looked up again even if PATH is assigned its own value, as `hash -r` does.
+        path_cmdflush();
+        path_indexflush();
         if (path_scoped && !val) val = FETCH_VT(PATHNOD->nvalue, const_cp);
     }
     const char *cp = FETCH_VT(np->nvalue, const_cp);
@@ -290,6 +293,7 @@ static_fn void put_restricted(Namval_t *np, const void *val, nvflag_t flags, Nam
     if (np == FPATHNOD || (fpath_scoped = (strcmp(name, FPATHNOD->nvname) == 0))) {
         shp->pathlist = path_unsetfpath(shp);
     }
+    if (np == FPATHNOD || fpath_scoped) path_cmdflush();
     nv_putv(np, val, flags, fp);
     shp->universe = 0;
     if (shp->pathlist) {
@@ -117,6 +117,7 @@ struct _mac_ {
 static_fn int substring(const char *, size_t, const char *, int[], int);
 static_fn void copyto(Mac_t *, int, int);
 static_fn void comsubst(Mac_t *, Shnode_t *, int);
+static_fn bool comsub_isexternal(Shell_t *, const Shnode_t *);
 static_fn bool varsub(Mac_t *);
 static_fn void mac_copy(Mac_t *, const char *, size_t);
 static_fn void tilde_expand2(Shell_t *, int);
@@ -1929,7 +1930,7 @@ static_fn void comsubst(Mac_t *mp, Shnode_t *t, volatile int type) {
             } else if ((t->ar.arexpr->argflag & ARG_RAW)) {
                 num = sh_arith(mp->shp, t->ar.arexpr->argval);
             } else {
-                num = sh_arith(mp->shp, sh_mactrim(mp->shp, t->ar.arexpr->argval, 3));
+                num = sh_arithcache(mp->shp, sh_mactrim(mp->shp, t->ar.arexpr->argval, 3));
             }
             mp->shp->inarith = 0;
         out_offset:
@@ -2007,6 +2008,12 @@ static_fn void comsubst(Mac_t *mp, Shnode_t *t, volatile int type) {
             }
             type = 3;
         } else {
+            // A command substitution that will fork anyway streams its output through a pipe
+            // from the child rather than spilling it to a temporary file.
+            if (type == 3 && !sh_isoption(mp->shp, SH_SUBSHARE) &&
+                comsub_isexternal(mp->shp, t)) {
+                type = 1;
+            }
             sp = sh_subshell(mp->shp, t, sh_isstate(mp->shp, SH_ERREXIT), type);
         }
         fcrestore(&save);
@@ -2046,6 +2053,11 @@ static_fn void comsubst(Mac_t *mp, Shnode_t *t, volatile int type) {
         for (nextnewlines = 0; c > 0 && str[c - 1] == '\n'; c--, nextnewlines++) {
             ;  // empty loop
         }
+        if (c == 0) {
+            // A pipe can deliver the trailing new-lines in a read of their own.
+            newlines += nextnewlines;
+            continue;
+        }
         if (newlines > 0) {
             if (mp->sp) {
                 sfnputc(mp->sp, '\n', newlines);
@@ -2073,6 +2085,33 @@ static_fn void comsubst(Mac_t *mp, Shnode_t *t, volatile int type) {
     return;
 }
 
+//
+// Return true if <t> is a simple command that is known to run an external program. Only commands
+// given by pathname or already in the tracked alias table qualify since a path search here could
+// autoload a function outside the subshell.
+//
+static_fn bool comsub_isexternal(Shell_t *shp, const Shnode_t *t) {
+    const char *name;
+    Namval_t *np;
+
+    if ((t->tre.tretyp & COMMSK) != TCOM || (t->tre.tretyp & (FAMP | FPOU | FCOOP | FSHOWME))) {
+        return false;
+    }
+    if (!t->com.comarg || t->com.comset || t->com.comnamp) return false;
+    if (t->tre.tretyp & COMSCAN) {
+        if (!(t->com.comarg->argflag & ARG_RAW)) return false;
+        name = t->com.comarg->argval;
+    } else {
+        name = ((struct dolnod *)t->com.comarg)->dolval[ARG_SPARE];
+    }
+    if (!name || !*name) return false;
+    if (nv_search(name, shp->fun_tree, 0) || nv_search(name, shp->bltin_tree, 0)) return false;
+    if (strchr(name, '/')) return true;
+    np = nv_search(name, shp->track_tree, 0);
+    if (!np || nv_isattr(np, NV_NOALIAS) || !FETCH_VT(np->nvalue, const_cp)) return false;
+    return !nv_search(nv_getval(np), shp->bltin_tree, 0);
+}
+
 //
 // Copy <str> onto the stack.
 //
@@ -2165,9 +2204,21 @@ static_fn void mac_copy(Mac_t *mp, const char *str, size_t size) {
             }
             if (ifs_state[ESCAPE] == 0) ifs_state[ESCAPE] = S_ESC;
         }
-        while (size-- > 0) {
+        int wide = mbwide();
+        while (size > 0) {
+            // Copy a run of ordinary single byte characters in one piece.
+            const char *sp = cp;
+            while (size > 0 && !ifs_state[c = *(unsigned char *)cp] && (c < 0x80 || !wide)) {
+                cp++;
+                size--;
+            }
+            if (cp > sp) {
+                sfwrite(stkp, sp, cp - sp);
+                if (size <= 0) break;
+            }
+            size--;
             n = ifs_state[c = *(unsigned char *)cp++];
-            if (n != S_MBYTE && (len = mblen(cp - 1, ep - cp + 1)) > 1) {
+            if (wide && n != S_MBYTE && (len = mblen(cp - 1, ep - cp + 1)) > 1) {
                 sfwrite(stkp, cp - 1, len);
                 cp += --len;
                 size -= len;
@@ -43,7 +43,8 @@
 #include "stk.h"
 #include "variables.h"
 
-#define NVCACHE 8  // must be a power of 2 and not zero
+#define NVCACHE_MIN 32    // initial number of nv_open() cache entries, must be a power of 2
+#define NVCACHE_MAX 1024  // the cache stops growing at this many entries
 
 // This var used to be writable but was treated as if it was immutable except for one assignment
 // that failed to validate it was modifying only the first, and only, char. So we now make it
@@ -103,6 +104,7 @@ struct adata {
     char **argnam;
     int attsize;
     char *attval;
+    bool dynamic;
 };
 
 struct sh_type {
@@ -113,6 +115,11 @@ struct sh_type {
     short maxnodes;
 };
 
+//
+// Cache of nv_open() lookups hashed by name and scope. Each entry is also chained by the node it
+// resolves to so that nv_delete() can invalidate exactly the entries for that node. The cache
+// doubles in size when live entries keep getting replaced.
+//
 struct Namcache {
     struct Cache_entry {
         Dt_t *root;
@@ -121,15 +128,87 @@ struct Namcache {
         Namval_t *np;
         Namval_t *last_table;
         Namval_t *namespace;
+        struct Cache_entry *nextnode;  // next entry in the same node bucket
         nvflag_t flags;
         short size;
         short len;
-    } entries[NVCACHE];
-    short index;
+    } * entries;
+    struct Cache_entry **nodes;  // entries indexed by node
+    int size;                    // number of entries, a power of 2
+    int evictions;               // live entries replaced since the cache last grew
     short ok;
 };
 static struct Namcache nvcache;
 
+//
+// Hash at most `len` bytes of the variable name at the start of `name`.
+//
+static_fn unsigned int cache_hash(const char *name, size_t len, Dt_t *root) {
+    unsigned int h = (unsigned int)((uintptr_t)root >> 4);
+    int c;
+
+    while (len-- > 0 && (c = *name++) && c != '=' && c != '+') h = h * 33 + c;
+    return h & (nvcache.size - 1);
+}
+
+static_fn struct Cache_entry **cache_bucket(Namval_t *np) {
+    return &nvcache.nodes[((uintptr_t)np >> 4) & (nvcache.size - 1)];
+}
+
+//
+// Remove entry `xp` from its node bucket and mark it unused.
+//
+static_fn void cache_unlink(struct Cache_entry *xp) {
+    struct Cache_entry **pp;
+
+    for (pp = cache_bucket(xp->np); *pp; pp = &(*pp)->nextnode) {
+        if (*pp == xp) {
+            *pp = xp->nextnode;
+            break;
+        }
+    }
+    xp->nextnode = NULL;
+    xp->root = NULL;
+}
+
+//
+// Invalidate the entries for lookups in scope `root` before it is closed. They can resolve to nodes
+// in an enclosing scope which outlive it.
+//
+static_fn void cache_unscope(Dt_t *root) {
+    struct Cache_entry *xp;
+
+    for (xp = nvcache.entries; xp < &nvcache.entries[nvcache.size]; xp++) {
+        if (xp->root == root) cache_unlink(xp);
+    }
+}
+
+//
+// Allocate the cache with `size` empty entries.
+//
+static_fn bool cache_init(int size) {
+    struct Cache_entry *xp;
+
+    if (nvcache.entries) {
+        for (xp = nvcache.entries; xp < &nvcache.entries[nvcache.size]; xp++) free(xp->name);
+        free(nvcache.entries);
+        free(nvcache.nodes);
+    }
+    nvcache.entries = calloc(size, sizeof(struct Cache_entry));
+    nvcache.nodes = calloc(size, sizeof(struct Cache_entry *));
+    if (!nvcache.entries || !nvcache.nodes) {
+        free(nvcache.entries);
+        free(nvcache.nodes);
+        nvcache.entries = NULL;
+        nvcache.nodes = NULL;
+        nvcache.size = 0;
+        return false;
+    }
+    nvcache.size = size;
+    nvcache.evictions = 0;
+    return true;
+}
+
 bool nv_local = false;
 
 // ======== name value pair routines ========
@@ -1118,10 +1197,19 @@ if(np==nv_refnode(np)){
 // If np==0  && !root && flags==0,  delete the Refdict dictionary.
 //
 void nv_delete(Namval_t *np, Dt_t *root, nvflag_t flags) {
-    int c;
     struct Cache_entry *xp;
-    for (c = 0, xp = nvcache.entries; c < NVCACHE; xp = &nvcache.entries[++c]) {
-        if (xp->np == np) xp->root = NULL;
+
+    if (nvcache.size && np) {
+        struct Cache_entry **pp = cache_bucket(np);
+        while ((xp = *pp)) {
+            if (xp->np == np) {
+                *pp = xp->nextnode;
+                xp->nextnode = NULL;
+                xp->root = NULL;
+            } else {
+                pp = &xp->nextnode;
+            }
+        }
     }
     if (!np && !root && flags == 0) {
         if (Refdict) dtclose(Refdict);
@@ -1253,9 +1341,9 @@ Namval_t *nv_open(const char *name, Dt_t *root, nvflag_t flags) {
     }
     c = !isaletter(c);
     if (c) goto skip;
-    for (c = 0, xp = nvcache.entries; c < NVCACHE; xp = &nvcache.entries[++c]) {
-        if (xp->root != root) continue;
-        if ((*name != '_' || name[1] != '.') && *name == *xp->name &&
+    if (nvcache.size || cache_init(NVCACHE_MIN)) {
+        xp = &nvcache.entries[cache_hash(name, SIZE_MAX, root)];
+        if (xp->root == root && (*name != '_' || name[1] != '.') && *name == *xp->name &&
             xp->namespace == shp->namespace && (flags & (NV_ARRAY | NV_NOSCOPE)) == xp->flags &&
             strncmp(xp->name, name, xp->len) == 0 &&
             (name[xp->len] == 0 || name[xp->len] == '=' || name[xp->len] == '+')) {
@@ -1267,8 +1355,9 @@ Namval_t *nv_open(const char *name, Dt_t *root, nvflag_t flags) {
             shp->last_root = xp->last_root;
             goto nocache;
         }
+        sh_stats(STAT_NVMISSES);
+        nvcache.ok = 1;
     }
-    nvcache.ok = 1;
 #if SHOPT_BASH
     if (root == shp->fun_tree && sh_isoption(shp, SH_BASH)) {
         nvflag_t nvflags = 0;
@@ -1283,14 +1372,25 @@ Namval_t *nv_open(const char *name, Dt_t *root, nvflag_t flags) {
         cp = fun.last;
     }
     if (np && nvcache.ok && cp[-1] != ']') {
-        xp = &nvcache.entries[nvcache.index];
+        size_t len;
         if (*cp) {
             char *sp = strchr(name, *cp);
             if (!sp) goto nocache;
-            xp->len = sp - name;
+            len = sp - name;
         } else {
-            xp->len = strlen(name);
+            len = strlen(name);
+        }
+        if (len > SHRT_MAX - 32) goto nocache;
+        if (nvcache.evictions > nvcache.size && nvcache.size < NVCACHE_MAX &&
+            !cache_init(2 * nvcache.size)) {
+            goto nocache;
         }
+        xp = &nvcache.entries[cache_hash(name, len, root)];
+        if (xp->root) {
+            cache_unlink(xp);
+            nvcache.evictions++;
+        }
+        xp->len = len;
         c = roundof(xp->len + 1, 32);
         if (c > xp->size) {
             if (xp->size == 0) {
@@ -1308,7 +1408,8 @@ Namval_t *nv_open(const char *name, Dt_t *root, nvflag_t flags) {
         xp->last_table = shp->last_table;
         xp->last_root = shp->last_root;
         xp->flags = (flags & (NV_ARRAY | NV_NOSCOPE));
-        nvcache.index = (nvcache.index + 1) & (NVCACHE - 1);
+        xp->nextnode = *cache_bucket(np);
+        *cache_bucket(np) = xp;
     }
 nocache:
     nvcache.ok = 0;
@@ -1926,8 +2027,10 @@ static_fn void pushnam(Namval_t *np, void *data) {
     if (nv_isattr(np, NV_IMPORT) && np->nvenv) {
         assert(np->nvenv_is_cp);
         *ap->argnam++ = (char *)np->nvenv;
-    } else if ((value = nv_getval(np))) {
-        *ap->argnam++ = staknam(ap->sh, np, value);
+    } else {
+        // A get discipline can change the value without an assignment.
+        if (nv_hasget(np)) ap->dynamic = true;
+        if ((value = nv_getval(np))) *ap->argnam++ = staknam(ap->sh, np, value);
     }
     if (nv_isattr(np,
                   NV_RDONLY | NV_UTOL | NV_LTOU | NV_RJUST | NV_LJUST | NV_ZFILL | NV_INTEGER)) {
@@ -1935,6 +2038,37 @@ static_fn void pushnam(Namval_t *np, void *data) {
     }
 }
 
+//
+// The environment list of the last sh_envgen() at global scope. It is reused until an exported
+// variable changes, which is recorded by env_change() through ast.env_serial.
+//
+static struct Envcache {
+    char **envp;
+    uint32_t serial;
+    int nenv;
+    bool valid;
+} envcache;
+
+//
+// Copy the environment list `er` into a single block so it outlives the stack.
+//
+static_fn char **envsave(char **er) {
+    char **ep, **envp, *cp;
+    size_t size = 3 * sizeof(char *);
+
+    for (ep = er; *ep; ep++) size += sizeof(char *) + strlen(*ep) + 1;
+    envp = malloc(size);
+    if (!envp) return NULL;
+    envp += 2;
+    cp = (char *)(envp + (ep - er) + 1);
+    for (ep = envp; *er; ep++, er++) {
+        *ep = cp;
+        cp = stpcpy(cp, *er) + 1;
+    }
+    *ep = NULL;
+    return envp;
+}
+
 //
 // Generate the environment list for the child.
 //
@@ -1944,11 +2078,17 @@ char **sh_envgen(Shell_t *shp) {
     char *cp;
     struct adata data;
 
+    // L_ARGNOD gets generated automatically as full path name of command.
+    nv_offattr(L_ARGNOD, NV_EXPORT);
+    // Local variables in a function scope can hide exported ones without an env_change().
+    if (envcache.valid && envcache.serial == ast.env_serial && envcache.nenv == shp->nenv &&
+        shp->var_tree == shp->var_base) {
+        return envcache.envp;
+    }
     data.sh = shp;
     data.tp = NULL;
     data.mapname = 0;
-    // L_ARGNOD gets generated automatically as full path name of command.
-    nv_offattr(L_ARGNOD, NV_EXPORT);
+    data.dynamic = false;
     data.attsize = 6;
     namec = nv_scan(shp->var_tree, NULL, NULL, NV_EXPORT, NV_EXPORT);
     namec += shp->nenv;
@@ -1963,6 +2103,17 @@ char **sh_envgen(Shell_t *shp) {
     *data.attval = 0;
     if (cp != data.attval) data.argnam++;
     *data.argnam = 0;
+    if (envcache.envp) {
+        free(envcache.envp - 2);
+        envcache.envp = NULL;
+    }
+    envcache.valid = false;
+    if (!data.dynamic && shp->var_tree == shp->var_base && (envcache.envp = envsave(er))) {
+        envcache.serial = ast.env_serial;
+        envcache.nenv = shp->nenv;
+        envcache.valid = true;
+        return envcache.envp;
+    }
     return er;
 }
 
@@ -2039,14 +2190,29 @@ int nv_scan(Dt_t *root, void (*fn)(Namval_t *, void *), void *data, nvflag_t mas
 }
 
 //
-// Create a new environment scope.
+// Every function call needs a scope dictionary. The ones sh_unscope() empties are kept here for
+// reuse rather than closed.
+//
+#define SCOPE_MAX 16
+static Dt_t *scopes[SCOPE_MAX];
+static int nscopes;
+
+//
+// Create a new environment scope. Functions are statically scoped, so the new scope views the
+// global (or namespace) dictionary rather than the caller's scope and the view chain stays the
+// same length however deeply calls nest.
 //
 void sh_scope(Shell_t *shp, struct argnod *envlist, int fun) {
     Dt_t *newscope, *newroot = (sh_isoption(shp, SH_BASH) ? shp->var_tree : shp->var_base);
     struct Ufunction *rp;
 
     if (shp->namespace) newroot = nv_dict(shp->namespace);
-    newscope = dtopen(&_Nvdisc, Dtoset);
+    if (nscopes > 0) {
+        newscope = scopes[--nscopes];
+        sh_stats(STAT_SCOPEHITS);
+    } else {
+        newscope = dtopen(&_Nvdisc, Dtoset);
+    }
     dtuserdata(newscope, shp, 1);
     if (envlist) {
         dtview(newscope, shp->var_tree);
@@ -2616,6 +2782,8 @@ void nv_newattr(Namval_t *np, nvflag_t newatts, int size) {
         if (size) nv_setsize(np, size);
         if (nv_isattr(np, NV_NOFREE)) newatts |= NV_NOFREE;
         nv_setattr(np, newatts);
+        // The attributes are exported too.
+        if (nv_isattr(np, NV_EXPORT)) env_change();
         return;
     }
     // For an array, change all the elements.
@@ -2773,9 +2941,9 @@ static_fn void cache_purge(const char *name) {
     size_t len = strlen(name);
     struct Cache_entry *xp;
 
-    for (c = 0, xp = nvcache.entries; c < NVCACHE; xp = &nvcache.entries[++c]) {
-        if (xp->len <= len || xp->name[len] != '.') continue;
-        if (strncmp(name, xp->name, len) == 0) xp->root = NULL;
+    for (c = 0, xp = nvcache.entries; c < nvcache.size; xp = &nvcache.entries[++c]) {
+        if (!xp->root || xp->len <= len || xp->name[len] != '.') continue;
+        if (strncmp(name, xp->name, len) == 0) cache_unlink(xp);
     }
 }
 
@@ -3113,7 +3281,12 @@ void sh_unscope(Shell_t *shp) {
             shp->st.real_fun->sdict->view = dp;
         }
         shp->var_tree = dp;
-        dtclose(root);
+        cache_unscope(root);
+        if (nscopes < SCOPE_MAX && !dtfirst(root)) {
+            scopes[nscopes++] = root;
+        } else {
+            dtclose(root);
+        }
     }
 }
 
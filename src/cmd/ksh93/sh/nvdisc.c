@@ -1086,6 +1086,7 @@ Namval_t *sh_addbuiltin(Shell_t *shp, const char *path, Shbltin_f bltin, void *e
     Namval_t *np, *nq = NULL;
     int offset = stktell(shp->stk);
 
+    path_cmdflush();
     if (extra == builtin_delete) {
         name = path;
     } else if ((name = path_basename(path)) == path &&
@@ -1224,6 +1225,7 @@ static_fn void put_table(Namval_t *np, const void *val, nvflag_t flags, Namfun_t
         _nv_unset(mp, flags);
         nq = dtnext(root, mp);
         dtdelete(root, mp);
+        nv_delete(mp, NULL, NV_NOFREE);
         free(mp);
     }
     dtclose(root);
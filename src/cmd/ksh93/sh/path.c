@@ -23,6 +23,7 @@
 //
 #include "config_ast.h"  // IWYU pragma: keep
 
+#include <dirent.h>
 #include <dlfcn.h>
 #include <errno.h>
 #include <fcntl.h>
@@ -33,8 +34,13 @@
 #include <stdlib.h>
 #include <string.h>
 #include <sys/stat.h>
+#include <time.h>
 #include <unistd.h>
 
+#if _lib_posix_spawn
+#include <spawn.h>
+#endif
+
 #include "argnod.h"
 #include "ast.h"
 #include "ast_assert.h"
@@ -53,6 +59,7 @@
 #include "shcmd.h"
 #include "stk.h"
 #include "test.h"
+#include "tv.h"
 #include "variables.h"
 
 #if USE_SPAWN
@@ -293,6 +300,291 @@ skip:
     return cp;
 }
 
+//
+// The entries of each absolute $PATH directory are read into a hashed index the first time the
+// directory is searched, so that names that are not there can be skipped without a stat(). An
+// index is trusted for PATH_INDEX_TTL seconds after the mtime of its directory was last checked.
+// Before path_absolute() reports a command as not found it checks the mtime of every index it
+// trusted, so commands that were just added to a directory are still found. Indexes are kept by
+// directory name so that they survive assignments to PATH, but path_indexflush() is called for
+// `hash -r` and assignments to PATH so that every directory is checked by the next lookup.
+//
+#define PATH_INDEX_TTL 1
+#define PATH_INDEX_MAX (1 << 20)  // larger directories are not indexed
+
+struct pathindex {
+    struct pathindex *next;
+    char *dir;
+    dev_t dev;
+    ino_t ino;
+    time_t mtime;
+    long mtime_nsec;
+    time_t checked;       // when the mtime was last checked
+    unsigned int lookup;  // path_absolute() call that last checked the mtime
+    bool valid;           // table holds the directory entries, empty if there is no directory
+    bool racy;            // directory changed too recently to trust the entries read
+    unsigned int mask;    // hash table size - 1
+    unsigned int *table;  // offset of name in names + 1, 0 if slot is empty
+    char *names;
+};
+
+static struct pathindex *path_indexes;
+
+static_fn unsigned int path_hash(const char *name) {
+    unsigned int h = 0;
+
+    while (*name) h = h * 33 + *(unsigned char *)name++;
+    return h;
+}
+
+static_fn struct pathindex *path_indexget(const char *dir) {
+    struct pathindex *ip;
+    size_t n;
+
+    for (ip = path_indexes; ip; ip = ip->next) {
+        if (!strcmp(ip->dir, dir)) return ip;
+    }
+    n = strlen(dir) + 1;
+    ip = calloc(1, sizeof(struct pathindex) + n);
+    if (!ip) return NULL;
+    ip->dir = memcpy(ip + 1, dir, n);
+    ip->next = path_indexes;
+    path_indexes = ip;
+    return ip;
+}
+
+//
+// Make the next lookup check the mtime of every indexed directory.
+//
+void path_indexflush(void) {
+    struct pathindex *ip;
+
+    for (ip = path_indexes; ip; ip = ip->next) ip->checked = 0;
+}
+
+static_fn void path_indexclear(struct pathindex *ip) {
+    free(ip->table);
+    free(ip->names);
+    ip->table = NULL;
+    ip->names = NULL;
+    ip->mask = 0;
+    ip->valid = false;
+}
+
+//
+// Read the entries of the directory of <ip> whose stat info is <sp> into the index.
+//
+static_fn bool path_indexread(struct pathindex *ip, struct stat *sp, time_t now) {
+    struct dirent *dp;
+    DIR *dir;
+    char *names = NULL;
+    char *cp;
+    unsigned int *table;
+    unsigned int count = 0;
+    unsigned int mask;
+    unsigned int i;
+    size_t size = 0;
+    size_t used = 0;
+    size_t n;
+
+    path_indexclear(ip);
+    dir = opendir(ip->dir);
+    if (!dir) return false;
+    while ((dp = readdir(dir))) {
+        if (dp->d_name[0] == '.' &&
+            (!dp->d_name[1] || (dp->d_name[1] == '.' && !dp->d_name[2]))) {
+            continue;
+        }
+        n = strlen(dp->d_name) + 1;
+        if (used + n > size) {
+            size = 2 * size + n + 1024;
+            cp = realloc(names, size);
+            if (!cp) break;
+            names = cp;
+        }
+        memcpy(names + used, dp->d_name, n);
+        used += n;
+        if (++count > PATH_INDEX_MAX) break;
+    }
+    closedir(dir);
+    if (dp) {
+        free(names);
+        return false;
+    }
+    for (mask = 15; mask < 2 * count; mask = 2 * mask + 1) {
+        ;  // empty loop
+    }
+    table = calloc(mask + 1, sizeof(*table));
+    if (!table) {
+        free(names);
+        return false;
+    }
+    for (n = 0; n < used; n += strlen(names + n) + 1) {
+        for (i = path_hash(names + n) & mask; table[i]; i = (i + 1) & mask) {
+            ;  // empty loop
+        }
+        table[i] = n + 1;
+    }
+    ip->table = table;
+    ip->names = names;
+    ip->mask = mask;
+    ip->valid = true;
+    ip->racy = sp->st_mtime >= now - PATH_INDEX_TTL;
+    return true;
+}
+
+//
+// Returns false if <name> is known not to be in $PATH directory <pp>. <lookup> identifies the
+// path_absolute() call. <trusted> is set if the answer came from an index whose directory was not
+// checked by this call. If <check> is set the directory is checked regardless of its age.
+//
+static_fn bool path_inindex(Pathcomp_t *pp, const char *name, unsigned int lookup, bool *trusted,
+                            bool check) {
+    static unsigned int nowlookup;
+    static time_t now;
+    struct pathindex *ip = pp->index;
+    struct stat statb;
+    unsigned int i;
+
+    if (*pp->name != '/' || (pp->flags & (PATH_FPATH | PATH_BFPATH | PATH_BUILTIN_LIB)) ||
+        !(pp->flags & PATH_PATH)) {
+        return true;
+    }
+    if (!ip && !(ip = pp->index = path_indexget(pp->name))) return true;
+    if (nowlookup != lookup) {
+        nowlookup = lookup;
+        now = time(NULL);
+    }
+    if (ip->lookup != lookup && (check || ip->racy || !ip->checked || now < ip->checked ||
+                                 now - ip->checked >= PATH_INDEX_TTL)) {
+        ip->checked = now;
+        ip->lookup = lookup;
+        if (stat(ip->dir, &statb) < 0 || !S_ISDIR(statb.st_mode)) {
+            // A missing directory has no entries.
+            path_indexclear(ip);
+            ip->valid = true;
+            ip->racy = false;
+            ip->ino = 0;
+        } else if (!ip->valid || ip->racy || ip->ino != statb.st_ino ||
+                   ip->dev != statb.st_dev || ip->mtime != statb.st_mtime ||
+                   ip->mtime_nsec != ST_MTIME_NSEC_GET(&statb)) {
+            ip->dev = statb.st_dev;
+            ip->ino = statb.st_ino;
+            ip->mtime = statb.st_mtime;
+            ip->mtime_nsec = ST_MTIME_NSEC_GET(&statb);
+            path_indexread(ip, &statb, now);
+        }
+    } else if (ip->lookup != lookup) {
+        *trusted = true;
+    }
+    if (!ip->valid) return true;
+    if (ip->table) {
+        for (i = path_hash(name) & ip->mask; ip->table[i]; i = (i + 1) & ip->mask) {
+            if (!strcmp(ip->names + ip->table[i] - 1, name)) return true;
+        }
+    }
+    return false;
+}
+
+//
+// Check the directories of the $PATH indexes trusted by path_absolute() call <lookup> starting at
+// <pp>. Returns true if <name> has been added to one of them.
+//
+static_fn bool path_indexcheck(Pathcomp_t *pp, const char *name, unsigned int lookup) {
+    bool trusted;
+
+    for (; pp; pp = pp->next) {
+        if ((pp->flags & PATH_SKIP) || !pp->index || pp->index->lookup == lookup) continue;
+        if (path_inindex(pp, name, lookup, &trusted, true)) return true;
+    }
+    return false;
+}
+
+//
+// Cache of what simple command names resolved to in sh_exec(), hashed by name. An entry holds the
+// function or built-in the name resolved to, or the pathname of the command found on $PATH.
+// Anything that can change what a name resolves to calls path_cmdflush(), which invalidates every
+// entry by starting a new generation. Commands found on $PATH are trusted for PATH_INDEX_TTL
+// seconds like the directory indexes.
+//
+#define PATH_CMDCACHE 256  // must be a power of 2
+
+struct cmdcache {
+    char *name;
+    char *path;        // pathname of the command on $PATH, NULL for functions and built-ins
+    Namval_t *np;      // function or built-in, NULL for an external command
+    time_t found;      // when path was found
+    unsigned int gen;  // generation the entry belongs to
+    size_t size;       // allocated size of name and path
+};
+
+static struct cmdcache path_cmds[PATH_CMDCACHE];
+static unsigned int path_cmdgeneration = 1;
+
+//
+// Returns true if <name> is in the command cache. The function or built-in it resolved to is
+// returned in <npp> and the pathname of an external command in <pathp> if not NULL.
+//
+bool path_cmdget(Shell_t *shp, const char *name, Namval_t **npp, const char **pathp) {
+    struct cmdcache *cp = &path_cmds[path_hash(name) & (PATH_CMDCACHE - 1)];
+    time_t now;
+
+    if (cp->gen != path_cmdgeneration || strcmp(cp->name, name) || sh_isstate(shp, SH_DEFPATH)) {
+        return false;
+    }
+    if (cp->path) {
+        now = time(NULL);
+        if (now < cp->found || now - cp->found >= PATH_INDEX_TTL) return false;
+    }
+    sh_stats(STAT_CMDHITS);
+    *npp = cp->np;
+    if (pathp) *pathp = cp->path;
+    return true;
+}
+
+//
+// Enter <name> in the command cache as resolving to function or built-in <np> or, if <path> is not
+// NULL, to the command <path> found on $PATH. Commands in relative $PATH directories are not
+// cached since they depend on the current directory.
+//
+void path_cmdput(Shell_t *shp, const char *name, Namval_t *np, const char *path) {
+    struct cmdcache *cp = &path_cmds[path_hash(name) & (PATH_CMDCACHE - 1)];
+    size_t n = strlen(name) + 1;
+    size_t m = path ? strlen(path) + 1 : 0;
+    char *sp;
+
+    if (sh_isstate(shp, SH_DEFPATH) || (path && *path != '/')) return;
+    cp->gen = 0;
+    if (n + m > cp->size) {
+        sp = realloc(cp->name, n + m);
+        if (!sp) return;
+        cp->name = sp;
+        cp->size = n + m;
+    }
+    memcpy(cp->name, name, n);
+    cp->path = path ? memcpy(cp->name + n, path, m) : NULL;
+    cp->np = np;
+    if (path) cp->found = time(NULL);
+    cp->gen = path_cmdgeneration;
+}
+
+//
+// Invalidate the command cache.
+//
+void path_cmdflush(void) {
+    struct cmdcache *cp;
+
+    if (++path_cmdgeneration == 0) {
+        for (cp = path_cmds; cp < &path_cmds[PATH_CMDCACHE]; cp++) cp->gen = 0;
+        path_cmdgeneration = 1;
+    }
+}
+
+//
+// Returns the generation of the command cache. It changes whenever the cache is flushed.
+//
+unsigned int path_cmdgen(void) { return path_cmdgeneration; }
+
 //
 // Delete current Pathcomp_t structure.
 //
@@ -694,8 +986,11 @@ static_fn bool pwdinfpath(void) {
 // Do a path search and find the full pathname of file name.
 //
 Pathcomp_t *path_absolute(Shell_t *shp, const char *name, Pathcomp_t *pp) {
+    static unsigned int lookup;
     int f, isfun;
     int noexec = 0;
+    bool trusted = false;
+    Pathcomp_t *first;
     Pathcomp_t *oldpp;
     Namval_t *np;
     char *cp;
@@ -703,6 +998,9 @@ Pathcomp_t *path_absolute(Shell_t *shp, const char *name, Pathcomp_t *pp) {
     shp->path_err = ENOENT;
     if (!pp && !(pp = path_get(shp, ""))) return 0;
     shp->path_err = 0;
+    first = pp;
+    lookup++;
+again:
     while (1) {
         sh_sigcheck(shp);
         shp->bltin_dir = NULL;
@@ -713,6 +1011,11 @@ Pathcomp_t *path_absolute(Shell_t *shp, const char *name, Pathcomp_t *pp) {
             if (!(oldpp->flags & PATH_SKIP)) break;
         }
         if (!oldpp) {
+            if (trusted && path_indexcheck(first, name, lookup)) {
+                trusted = false;
+                pp = first;
+                continue;
+            }
             shp->path_err = ENOENT;
             return NULL;
         }
@@ -810,8 +1113,13 @@ Pathcomp_t *path_absolute(Shell_t *shp, const char *name, Pathcomp_t *pp) {
             }
         }
         shp->bltin_dir = NULL;
-        sh_stats(STAT_PATHS);
-        f = can_execute(shp, stkptr(shp->stk, PATH_OFFSET), isfun);
+        if (!isfun && !strchr(name, '/') && !path_inindex(oldpp, name, lookup, &trusted, false)) {
+            f = -1;
+            errno = ENOENT;
+        } else {
+            sh_stats(STAT_PATHS);
+            f = can_execute(shp, stkptr(shp->stk, PATH_OFFSET), isfun);
+        }
         if (isfun && f >= 0 && (cp = strrchr(name, '.'))) {
             *cp = 0;
             if (nv_open(name, sh_subfuntree(shp, 1), NV_NOARRAY | NV_IDENT | NV_NOSCOPE)) f = -1;
@@ -838,6 +1146,12 @@ Pathcomp_t *path_absolute(Shell_t *shp, const char *name, Pathcomp_t *pp) {
         if (!pp || f >= 0) break;
         if (errno != ENOENT) noexec = errno;
     }
+    if (f < 0 && trusted && path_indexcheck(first, name, lookup)) {
+        // The command was added to a directory since its index was last checked.
+        trusted = false;
+        pp = first;
+        goto again;
+    }
     if (f < 0) {
         shp->path_err = (noexec ? noexec : ENOENT);
         return NULL;
@@ -1192,6 +1506,44 @@ retry:
     return 0;
 }
 
+#if !USE_SPAWN && _lib_posix_spawn
+//
+// Start <opath> with posix_spawn() rather than fork() and exec. Unlike path_spawn() this doesn't
+// report errors or run scripts; -1 is returned and the caller is expected to fork instead.
+//
+pid_t path_fastspawn(Shell_t *shp, const char *opath, char *argv[], char *envp[]) {
+    posix_spawn_file_actions_t actions;
+    pid_t pid;
+    int pidsize, err;
+
+    // Leave room for inserting _= pathname in environment.
+    envp--;
+    stkseek(shp->stk, PATH_OFFSET);
+    pidsize = sfprintf(stkstd, "*%d*", getpid());
+    sfputr(shp->stk, opath, -1);
+    opath = stkfreeze(shp->stk, 1) + PATH_OFFSET + pidsize;
+    envp[0] = (char *)opath - (PATH_OFFSET + pidsize);
+    envp[0][0] = '_';
+    envp[0][1] = '=';
+    if (posix_spawn_file_actions_init(&actions)) return -1;
+    // Ensure stdin, stdout, stderr are open in the child process like path_pfexecve() does.
+    for (int fd = 0; fd < 3; ++fd) {
+        if (fcntl(fd, F_GETFD, NULL) == -1) {
+            posix_spawn_file_actions_addopen(&actions, fd, "/dev/null", O_RDWR, 0);
+        }
+    }
+    sfsync(sfstderr);
+    err = posix_spawn(&pid, opath, &actions, NULL, argv, envp);
+    posix_spawn_file_actions_destroy(&actions);
+    if (err) {
+        errno = err;
+        return -1;
+    }
+    sh_stats(STAT_SPAWN);
+    return pid;
+}
+#endif  // !USE_SPAWN && _lib_posix_spawn
+
 //
 // File is executable but not machine code. Assume file is a Shell script and execute it.
 //
@@ -31,6 +31,7 @@
 #include <setjmp.h>
 #include <signal.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdlib.h>
 #include <string.h>
 #include <sys/stat.h>
@@ -68,6 +69,13 @@ struct Link {
     Namval_t *node;
 };
 
+// A saved variable is a `struct Link` whose trailing `Namval_t` (starting at `dict`) holds the
+// clone. The cdt link that indexes it by `node` in the subshell's `svardict` follows the clone.
+#define LINK_SIZE (sizeof(Namval_t) + 2 * sizeof(void *))
+
+static Dtdisc_t _Linkdisc = {
+    .key = offsetof(struct Link, node), .size = sizeof(Namval_t *), .link = LINK_SIZE};
+
 //
 // The following structure is used for command substitution and (...).
 //
@@ -77,9 +85,11 @@ static struct subshell {
     struct subshell *pipe;  // subshell where output goes to pipe on fork
     Dt_t *var;              // variable table at time of subshell
     struct Link *svar;      // save shell variable table
+    Dt_t *svardict;         // index of svar by node, created on first save
     Dt_t *sfun;             // function scope for subshell
     Dt_t *salias;           // alias scope for subshell
     Pathcomp_t *pathlist;   // for PATH variable
+    unsigned int cmdgen;    // command cache generation at time of subshell
     struct Error_context_s *errcontext;
     Shopt_t options;    // save shell options
     pid_t subpid;       // child process id
@@ -222,21 +232,22 @@ bool nv_subsaved(Namval_t *np, bool table) {
     struct subshell *sp;
     struct Link *lp, *lpprev;
     for (sp = (struct subshell *)subshell_data; sp; sp = sp->prev) {
-        lpprev = 0;
-        for (lp = sp->svar; lp; lpprev = lp, lp = lp->next) {
-            if (lp->node == np) {
-                if (table) {
-                    if (lpprev) {
-                        lpprev->next = lp->next;
-                    } else {
-                        sp->svar = lp->next;
-                    }
-                    free(np);
-                    free(lp);
-                }
-                return true;
+        if (!sp->svardict || !dtmatch(sp->svardict, &np)) continue;
+        if (table) {
+            lpprev = 0;
+            for (lp = sp->svar; lp->node != np; lpprev = lp, lp = lp->next) {
+                ;  // empty loop
+            }
+            if (lpprev) {
+                lpprev->next = lp->next;
+            } else {
+                sp->svar = lp->next;
             }
+            dtdelete(sp->svardict, lp);
+            free(np);
+            free(lp);
         }
+        return true;
     }
     return false;
 }
@@ -268,13 +279,16 @@ Namval_t *sh_assignok(Namval_t *np, int add) {
         sh_assignok(mp, add);
         if (!add || is_associative(ap)) return np;
     }
-    for (lp = sp->svar; lp; lp = lp->next) {
-        if (lp->node == np) return np;
+    if (!sp->svardict) {
+        sp->svardict = dtopen(&_Linkdisc, Dtset);
+    } else if (dtmatch(sp->svardict, &np)) {
+        return np;
     }
     // First two pointers use linkage from np.
-    lp = malloc(sizeof(*np) + 2 * sizeof(void *));
-    memset(lp, 0, sizeof(*mp) + 2 * sizeof(void *));
+    lp = calloc(1, LINK_SIZE + sizeof(Dtlink_t));
     lp->node = np;
+    dtinsert(sp->svardict, lp);
+    sh_stats(STAT_SUBSAVES);
     if (!add && nv_isvtree(np)) {
         Namval_t fake;
         Dt_t *walk, *root = shp->var_tree;
@@ -317,6 +331,11 @@ static_fn void nv_restore(struct subshell *sp) {
     Namval_t *mpnext;
     int flags, nofree;
     sp->shpwd = NULL;  // make sure sh_assignok doesn't save with nv_unset()
+    if (sp->svardict) {
+        // The links are freed below so the index must go first.
+        dtclose(sp->svardict);
+        sp->svardict = NULL;
+    }
     for (lp = sp->svar; lp; lp = lq) {
         np = (Namval_t *)&lp->dict;
         lq = lp->next;
@@ -400,6 +419,7 @@ Dt_t *sh_subfuntree(Shell_t *shp, int create) {
 static_fn void subshell_table_unset(Dt_t *root, int fun) {
     Namval_t *np, *nq;
 
+    if (fun) sh_arithflush();
     for (np = (Namval_t *)dtfirst(root); np; np = nq) {
         nq = (Namval_t *)dtnext(root, np);
         nvflag_t flag = 0;
@@ -500,6 +520,7 @@ Sfio_t *sh_subshell(Shell_t *shp, Shnode_t *t, volatile int flags, int comsub) {
     }
     if (!shp->pwd) path_pwd(shp);
     sp->bckpid = shp->bckpid;
+    sp->cmdgen = path_cmdgen();
     if (comsub) {
         sh_stats(STAT_COMSUB);
     } else {
@@ -556,12 +577,15 @@ Sfio_t *sh_subshell(Shell_t *shp, Shnode_t *t, volatile int flags, int comsub) {
             sh_offstate(shp, SH_MONITOR);
         }
         if (comsub == 1) {
+            // Fork now and let the parent read the output from a pipe as it is produced. The
+            // child exits when done so the last command can run without another fork.
             int fds[2];
             sh_rpipe(fds);
             sp->pipe = NULL;
             sp->pipefd = fds[0];
             sp->tmpfd = fds[1];
             sh_subfork();
+            flags |= sh_state(SH_NOFORK);
         } else if (comsub) {
             sp->pipe = sp;
             // Save sfstdout and status.
@@ -666,6 +690,8 @@ Sfio_t *sh_subshell(Shell_t *shp, Shnode_t *t, volatile int flags, int comsub) {
         path_delete(shp->pathlist);
         shp->pathlist = sp->pathlist;
     }
+    // Commands resolved in the subshell may depend on its PATH or functions.
+    if (path_cmdgen() != sp->cmdgen) path_cmdflush();
     job_subrestore(shp, sp->jobs);
     shp->jobenv = savecurenv;
     job.curpgid = savejobpgid;
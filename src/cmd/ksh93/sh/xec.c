@@ -83,6 +83,8 @@
 extern int nice(int);
 #if USE_SPAWN
 static_fn pid_t sh_ntfork(Shell_t *, const Shnode_t *, char *[], int *, int);
+#elif _lib_posix_spawn
+static_fn pid_t sh_spawn(Shell_t *, const Shnode_t *, char *[], int, int *);
 #endif  // USE_SPAWN
 
 static_fn void sh_funct(Shell_t *, Namval_t *, int, char *[], struct argnod *, int);
@@ -901,6 +903,7 @@ int sh_exec(Shell_t *shp, const Shnode_t *t, int flags) {
             Namval_t *np, *nq, *last_table;
             struct ionod *io;
             int command = 0;
+            bool cmdcache = false, cmdhit = false;
             nvflag_t nvflags = NV_ASSIGN;
             shp->bltindata.invariant = type >> (COMBITS + 2);
             shp->bltindata.pwdfd = shp->pwdfd;
@@ -958,9 +961,20 @@ int sh_exec(Shell_t *shp, const Shnode_t *t, int flags) {
             }
             if (com0) {
                 if (!np && !strchr(com0, '/')) {
-                    Dt_t *root = command ? shp->bltin_tree : shp->fun_tree;
-                    np = nv_bfsearch(com0, root, &nq, &cp);
-                    if (shp->namespace && !nq && !cp) np = sh_fsearch(shp, com0, 0);
+                    cmdcache = !command && !shp->namespace && !strpbrk(com0, ".[");
+                    if (cmdcache && path_cmdget(shp, com0, &np, NULL)) {
+                        nq = NULL;
+                        cmdcache = false;
+                        cmdhit = true;
+                    } else {
+                        Dt_t *root = command ? shp->bltin_tree : shp->fun_tree;
+                        np = nv_bfsearch(com0, root, &nq, &cp);
+                        if (shp->namespace && !nq && !cp) np = sh_fsearch(shp, com0, 0);
+                        if (cmdcache && np) {
+                            path_cmdput(shp, com0, np, NULL);
+                            cmdcache = false;
+                        }
+                    }
                 }
                 comn = com[argn - 1];
             }
@@ -1087,7 +1101,7 @@ int sh_exec(Shell_t *shp, const Shnode_t *t, int flags) {
                 }
                 if (io) sfsync(shp->outpool);
                 shp->lastpath = NULL;
-                if (!np && !strchr(com0, '/')) {
+                if (!np && !cmdhit && !strchr(com0, '/')) {
                     if (path_search(shp, com0, NULL, 1)) {
                         error_info.line = t->com.comline - shp->st.firstline;
                         if (!shp->namespace || !(np = sh_fsearch(shp, com0, 0))) {
@@ -1100,10 +1114,13 @@ int sh_exec(Shell_t *shp, const Shnode_t *t, int flags) {
                             ((Shnode_t *)t)->com.comtyp &= ~COMFIXED;
                             goto tryagain;
                         }
+                        if (cmdcache && np) path_cmdput(shp, com0, np, NULL);
                     } else {
                         if ((np = nv_search(com0, shp->track_tree, 0)) &&
                             !nv_isattr(np, NV_NOALIAS) && FETCH_VT(np->nvalue, const_cp)) {
-                            np = nv_search(nv_getval(np), shp->bltin_tree, 0);
+                            char *path = nv_getval(np);
+                            np = nv_search(path, shp->bltin_tree, 0);
+                            if (cmdcache) path_cmdput(shp, com0, np, path);
                         } else {
                             np = NULL;
                         }
@@ -1499,7 +1516,10 @@ int sh_exec(Shell_t *shp, const Shnode_t *t, int flags) {
                     break;
                 }
 #else   // USE_SPAWN
-                parent = sh_fork(shp, type, &jobid);
+#if _lib_posix_spawn
+                if (!com0 || (parent = sh_spawn(shp, t, com, type, &jobid)) < 0)
+#endif
+                    parent = sh_fork(shp, type, &jobid);
 #endif  // USE_SPAWN
             }
 #if SHOPT_COSHELL
@@ -2052,7 +2072,7 @@ int sh_exec(Shell_t *shp, const Shnode_t *t, int flags) {
             if (t->ar.arcomp) {
                 shp->exitval = !arith_exec((Arith_t *)t->ar.arcomp);
             } else {
-                shp->exitval = !sh_arith(shp, arg[1]);
+                shp->exitval = !sh_arithcache(shp, arg[1]);
             }
             break;
         }
@@ -2259,6 +2279,8 @@ int sh_exec(Shell_t *shp, const Shnode_t *t, int flags) {
             if (!np) {
                 np = nv_open(fname, sh_subfuntree(shp, 1), NV_NOARRAY | NV_VARNAME | NV_NOSCOPE);
             }
+            path_cmdflush();
+            sh_arithflush();
             if (npv) {
                 if (!shp->mktype) cp = nv_setdisc(npv, cp, np, (Namfun_t *)npv);
                 if (!cp) {
@@ -2869,7 +2891,7 @@ static_fn void coproc_init(Shell_t *shp, int pipes[]) {
     shp->fdptrs[shp->coutpipe] = &shp->coutpipe;
 }
 
-#if USE_SPAWN
+#if USE_SPAWN || _lib_posix_spawn
 
 static_fn void sigreset(Shell_t *shp, int mode) {
     char *trap;
@@ -2890,6 +2912,56 @@ static_fn void sigreset(Shell_t *shp, int mode) {
     }
 }
 
+#endif  // USE_SPAWN || _lib_posix_spawn
+
+#if !USE_SPAWN && _lib_posix_spawn
+//
+// Start the simple command <argv> with posix_spawn() when that can't be told apart from a fork
+// and exec. That is when job control is off, so there is no terminal process group to hand over,
+// and the command has no redirections or variable assignments and was found on $PATH. Returns -1
+// if the command doesn't qualify or couldn't be started, in which case the caller forks.
+//
+static_fn pid_t sh_spawn(Shell_t *shp, const Shnode_t *t, char *argv[], int type, int *jobid) {
+    Namval_t *np;
+    Pathcomp_t *pp;
+    const char *path = NULL;
+    char **envp;
+    pid_t pid;
+
+    if (sh_isstate(shp, SH_MONITOR) || job.jobcontrol || sh_isstate(shp, SH_DEFPATH)) return -1;
+    if (sh_isoption(shp, SH_RESTRICTED) || shp->xargmin) return -1;
+    if (t->com.comio || t->com.comset || (type & (FAMP | FPIN | FPOU | FCOOP))) return -1;
+    if (strchr(argv[0], '/')) {
+        path = argv[0];
+    } else if (!path_cmdget(shp, argv[0], &np, &path) || !path) {
+        np = nv_search(argv[0], shp->track_tree, 0);
+        if (!np || nv_isattr(np, NV_NOALIAS) || !FETCH_VT(np->nvalue, const_cp)) return -1;
+        path = nv_getval(np);
+        if (!path || *path != '/') return -1;
+    }
+    // Library components need the environment adjusted by path_spawn().
+    for (pp = shp->pathlist; pp; pp = pp->next) {
+        if (pp->lib) return -1;
+    }
+    envp = sh_envgen(shp);
+    sfsync(NULL);
+    sigreset(shp, 0);  // set signals to ignore
+    job_fork(-1);
+    pid = path_fastspawn(shp, path, argv, envp);
+    sigreset(shp, 1);  // restore ignored signals
+    if (pid < 0) {
+        // The sh_fork() that follows resets jobfork.
+        job_unlock();
+        return -1;
+    }
+    _sh_fork(shp, pid, type, jobid);
+    job_fork(pid);
+    return pid;
+}
+#endif  // !USE_SPAWN && _lib_posix_spawn
+
+#if USE_SPAWN
+
 //
 // A combined fork/exec for systems with slow or non-existent fork().
 //
@@ -2932,8 +3004,11 @@ static_fn pid_t sh_ntfork(Shell_t *shp, const Shnode_t *t, char *argv[], int *jo
         }
         if (!strchr(path = argv[0], '/')) {
             Namval_t *np;
-            np = nv_search(path, shp->track_tree, 0);
-            if (np && !nv_isattr(np, NV_NOALIAS) && FETCH_VT(np->nvalue, const_cp)) {
+            const char *cpath = NULL;
+            if (path_cmdget(shp, path, &np, &cpath) && cpath) {
+                path = stkcopy(shp->stk, cpath);
+            } else if ((np = nv_search(path, shp->track_tree, 0)) && !nv_isattr(np, NV_NOALIAS) &&
+                       FETCH_VT(np->nvalue, const_cp)) {
                 path = nv_getval(np);
             } else if (path_absolute(shp, path, NULL)) {
                 path = stkptr(shp->stk, PATH_OFFSET);
@@ -3113,16 +3188,23 @@ int sh_funscope(Shell_t *shp, int argn, char *argv[], int (*fun)(void *), void *
         }
     }
     shp->st.cmdname = argv[0];
-    // Save trap table.
+    // Save trap table. Nothing needs saving unless a trap is set. The caller keeps its trap
+    // strings and the function gets copies of the ignored signals sh_sigreset() leaves in place.
     nsig = shp->st.trapmax;
-    if (nsig > 0 || shp->st.trapcom[0]) {
-        savsig = malloc(nsig * sizeof(char *));
-        // Contents of shp->st.trapcom may change
-        for (isig = 0; isig < nsig; ++isig) {
-            savsig[isig] = shp->st.trapcom[isig] ? strdup(shp->st.trapcom[isig]) : NULL;
+    savsig = NULL;
+    for (isig = 0; isig < nsig; ++isig) {
+        if (shp->st.trapcom[isig]) {
+            savsig = stkalloc(shp->stk, nsig * sizeof(char *));
+            memcpy(savsig, shp->st.trapcom, nsig * sizeof(char *));
+            break;
         }
     }
     sh_sigreset(shp, 0);
+    if (savsig) {
+        for (isig = 0; isig < nsig; ++isig) {
+            if (shp->st.trapcom[isig]) shp->st.trapcom[isig] = strdup(shp->st.trapcom[isig]);
+        }
+    }
     argsav = sh_argnew(shp, argv, &saveargfor);
     sh_pushcontext(shp, buffp, SH_JMPFUN);
     errorpush(&buffp->err, 0);
@@ -3190,14 +3272,9 @@ int sh_funscope(Shell_t *shp, int argn, char *argv[], int (*fun)(void *), void *
     shp->topscope = (Shscope_t *)prevscope;
     nv_getval(sh_scoped(shp, IFSNOD));
     shp->end_fn = 0;
-    if (nsig) {
-        for (isig = 0; isig < nsig; ++isig) {
-            if (shp->st.trapcom[isig]) {
-                free(shp->st.trapcom[isig]);
-            }
-        }
-        memcpy(shp->st.trapcom, savsig, nsig * sizeof(char *));
-        free(savsig);
+    for (isig = 0; isig < nsig; ++isig) {
+        if (shp->st.trapcom[isig]) free(shp->st.trapcom[isig]);
+        shp->st.trapcom[isig] = savsig ? savsig[isig] : NULL;
     }
     shp->trapnote = 0;
     shp->options = options;
@@ -1069,3 +1069,85 @@ function f
 [[ $(( (2**32) << 67 )) == 0 ]] || log_error 'left shift count 67 is non-zero'
 
 [[ 0x123 -eq 0x122+0x1 ]] || log_error "[[...]] does not support math operations on hexadecimal numbers"
+
+# Integer variables are read and written directly by the arithmetic evaluator.
+typeset -i n32=2147483647
+(( n32++ ))
+[[ $n32 == -2147483648 ]] || log_error "typeset -i should wrap at 32 bits -- expected -2147483648, got $n32"
+integer n64=2147483647 sum=0 j
+(( n64++ ))
+[[ $n64 == 2147483648 ]] || log_error "integer should not wrap at 32 bits -- expected 2147483648, got $n64"
+for (( j=0; j < 1000; j++ ))
+do
+    (( sum += j ))
+done
+(( sum == 499500 )) || log_error "integer loop sum is wrong -- expected 499500, got $sum"
+( (( sum++ )) )
+(( sum == 499500 )) || log_error "arithmetic assignment in a subshell changed the parent -- got $sum"
+integer -x xint=1
+(( xint++ ))
+[[ $($SHELL -c 'print $xint') == 2 ]] || log_error 'arithmetic assignment to an exported integer is not exported'
+$SHELL -c 'integer -r rint=1; (( rint++ ))' 2> /dev/null && log_error 'arithmetic assignment to a readonly integer should fail'
+function intscope
+{
+    integer sum=5
+    (( sum++ ))
+    print $sum
+}
+[[ $(intscope) == 6 ]] || log_error 'arithmetic on a local integer is wrong'
+(( sum == 499500 )) || log_error "arithmetic on a local integer changed the global -- got $sum"
+unset j
+(( j = 7 ))
+[[ $j == 7 ]] || log_error "arithmetic assignment to an unset former integer is wrong -- got $j"
+
+# Expanded arithmetic expressions are compiled once and then reused.
+integer hits=${.sh.stats.arith_cachehit} misses=${.sh.stats.arith_cachemiss} k total=0
+op=+
+for (( k=0; k < 20; k++ ))
+do
+    (( total $op= k ))
+    total=$(( total $op 1 ))
+done
+(( total == 210 )) || log_error "cached arithmetic expansions give the wrong result -- expected 210, got $total"
+integer nhits=${.sh.stats.arith_cachehit}-hits nmisses=${.sh.stats.arith_cachemiss}-misses
+(( nhits >= 38 )) || log_error "expanded arithmetic expressions are not cached" ">= 38" "$nhits"
+(( nmisses <= 2 )) || log_error "expanded arithmetic expressions are compiled more than once" "<= 2" "$nmisses"
+function arithlocal
+{
+    typeset total=5
+    (( total $op= 1 ))
+    print $total
+}
+[[ $(arithlocal) == 6 ]] || log_error 'cached arithmetic expression does not use the local variable'
+(( total == 210 )) || log_error "cached arithmetic expression changed the global variable -- got $total"
+op=/
+( (( total $op 0 )) ) 2> /dev/null && log_error 'division by zero in a cached arithmetic expression should fail'
+
+# Cached expressions that call math functions are recompiled when a function is redefined or unset.
+function .sh.math.arithinc x { (( .sh.value = x + 1 )); }
+n=1
+(( $(( arithinc($n) )) == 2 && $(( arithinc($n) )) == 2 )) ||
+    log_error 'cached arithmetic expression calling a math function is wrong'
+unset -f .sh.math.arithinc
+function .sh.math.arithinc x { (( .sh.value = x + 100 )); }
+got=$(( arithinc($n) ))
+[[ $got == 101 ]] || log_error 'cached arithmetic expression calls a redefined math function' 101 "$got"
+unset -f .sh.math.arithinc
+got=$( { print $(( arithinc($n) )); } 2>&1 )
+[[ $got == *arithinc* ]] || log_error 'cached arithmetic expression calls an unset math function' "*arithinc*" "$got"
+
+# An expression that fails when it is run from the cache can still be replaced by another one.
+# `1 / zero` and `1 / oneey` hash to the same cache entry.
+integer zero=0 oneey=1
+div=/
+integer hits=${.sh.stats.arith_cachehit}
+for k in 1 2
+do
+    (( 1 $div zero )) 2> /dev/null && log_error 'cached division by zero should fail'
+done
+for k in 1 2 3
+do
+    (( 1 $div oneey ))
+done
+integer nhits=${.sh.stats.arith_cachehit}-hits
+(( nhits == 3 )) || log_error 'expanded arithmetic expressions are not cached after an arithmetic error' 3 "$nhits"
@@ -872,3 +872,17 @@ unset foo bar
 typeset -a foo=([1]=w [2]=x) bar=(a b c)
 foo+=("${bar[@]}")
 [[ $(typeset -p foo) == 'typeset -a foo=([1]=w [2]=x [3]=a [4]=b [5]=c)' ]] || log_error 'Appending does not work if array contains empty indexes'
+
+# Associative array subscripts are listed in order even after the table was used for lookups.
+typeset -A bigar
+for ((i=0; i < 300; i++)); do bigar[k$((i * 7 % 300))]=$i; done
+for ((i=0; i < 1000; i++)); do : ${bigar[k$((i % 300))]}; done
+bigar[zz]=x bigar[aa]=y
+keys=( "${!bigar[@]}" )
+(( ${#keys[@]} == 302 )) || log_error 'associative array has wrong number of subscripts' 302 ${#keys[@]}
+for ((i=1; i < ${#keys[@]}; i++)); do
+    [[ ${keys[i-1]} < ${keys[i]} ]] || { log_error 'associative array subscripts not in order'; break; }
+done
+function localar { typeset -A lar=([b]=2 [a]=1); typeset -p lar; }
+[[ $(localar) == 'typeset -A lar=([a]=1 [b]=2)' ]] || log_error 'local associative array not in order'
+unset bigar keys
@@ -610,6 +610,24 @@ touch "$TEST_DIR/corrupted_history"
 echo "sa;lfjsa;fj;sajfjs;fjdf" > "$TEST_DIR/corrupted_history"
 env HISTFILE="$TEST_DIR/corrupted_history" $SHELL -i -c "[[ $(history | wc -l) -eq 0 ]] && exit 0 || exit 1"
 
+# ==========
+# History searches find commands anywhere in a large history file
+actual=$(
+    {
+        print 'print needle in a haystack'
+        for ((i=0; i < 1000; i++))
+        do  print "print hay $i"
+        done
+        print "hist -p '!?needle?'"
+        print "hist -p '!?nowhere?'"
+        print "hist -p '!?hay 5?'"
+    } | ENV=/dev/null HISTSIZE=2000 HISTFILE="$TEST_DIR/search_history" $SHELL -i 2>&1 |
+        sed -e '1,/^# hay 999$/d' -e 's/^# //' -e 's/^.*: hist:/hist:/'
+)
+expect=$'print needle in a haystack\nhist: !?nowhere: event not found\nprint hay 599'
+[[ $actual == "$expect" ]] ||
+    log_error "history search failed" "$expect" "$actual"
+
 # ==========
 # umask - get or set the file creation mask
 set -- \
@@ -132,3 +132,26 @@ expect="a^Ib"
 actual=$(cat this_file_does_not_exist 2>&1)
 expect="this_file_does_not_exist: cannot open [No such file or directory]"
 [[ "$actual" =~ "$expect" ]] || log_error "cat should give an error on non-existent files" "$expect" "$actual"
+
+# ==========
+# Plain copies of regular files are done in the kernel when possible. Output already buffered by
+# the shell must come first and the stream positions must account for the copied bytes.
+builtin cat
+integer i
+for ((i = 0; i < 20000; i++))
+do
+    print "line $i of a file large enough to need more than one sfio buffer"
+done > "$TEST_DIR/large_file"
+expect=$(< "$TEST_DIR/large_file")
+{ print -n head; cat "$TEST_DIR/large_file"; print tail; } > "$TEST_DIR/large_copy"
+actual=$(< "$TEST_DIR/large_copy")
+[[ "$actual" == "head${expect}"$'\n'tail ]] || log_error "cat of a large file to a file failed"
+actual=$(cat "$TEST_DIR/large_file" | cat)
+[[ "$actual" == "$expect" ]] || log_error "cat of a large file to a pipe failed"
+{ read -N 5 head; cat; } < "$TEST_DIR/large_file" > "$TEST_DIR/large_copy"
+[[ "$head$(< "$TEST_DIR/large_copy")" == "$expect" ]] ||
+    log_error "cat of standard input does not start at the current offset"
+cat "$TEST_DIR/large_file" "$TEST_DIR/sample_file" "$TEST_DIR/large_file" > "$TEST_DIR/large_copy"
+actual=$(< "$TEST_DIR/large_copy")
+[[ "$actual" == "$expect"$'\n'"$(< "$TEST_DIR/sample_file")"$'\n'"$expect" ]] ||
+    log_error "cat of several large files failed"
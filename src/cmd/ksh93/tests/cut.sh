@@ -103,4 +103,37 @@ actual=$(cut -c -xyz "$TEST_DIR/foo" 2>&1)
 expect=$'cut: bad list for c/f option'
 [[ "$actual" =~ "$expect" ]] || log_error "'cut -b1 f1' should show an error" "$expect" "$actual"
 
+# ==========
+# Fields spanning buffer boundaries, long fields and lines with no delimiter are scanned a word at
+# a time in single byte locales.
+builtin cut
+integer i j
+long=xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx
+for ((i = 0; i < 3000; i++))
+do
+    if ((i % 7 == 0))
+    then
+        print "no delimiter $i"
+    else
+        for ((j = 1; j <= i % 11; j++))
+        do
+            print -rn -- "f$j-${long:0:i%83},"
+        done
+        print "end$i"
+    fi
+done > "$TEST_DIR/fields"
+for list in 1 2 3,7 2- 1,4- 3-5,9 20
+do
+    # The multibyte locale scans a character at a time.
+    expect=$(LC_ALL=C.UTF-8 cut -d, -f$list "$TEST_DIR/fields" | md5sum)
+    actual=$(LC_ALL=C cut -d, -f$list "$TEST_DIR/fields" | md5sum)
+    [[ $actual == "$expect" ]] || log_error "cut -d, -f$list of long lines failed"
+    expect=$(LC_ALL=C.UTF-8 cut -s -d, -f$list < "$TEST_DIR/fields" | md5sum)
+    actual=$(LC_ALL=C cut -s -d, -f$list < "$TEST_DIR/fields" | md5sum)
+    [[ $actual == "$expect" ]] || log_error "cut -s -d, -f$list of long lines failed"
+done
+actual=$(LC_ALL=C cut -d, -f3,7 "$TEST_DIR/fields" | sed -n '1p;2p;10p;12p')
+expect=$'no delimiter 0\n\nf3-xxxxxxxxx,f7-xxxxxxxxx\nend11'
+[[ $actual == "$expect" ]] || log_error "cut -d, -f3,7 failed" "$expect" "$actual"
+
 # TODO: Add tests for multibyte characters
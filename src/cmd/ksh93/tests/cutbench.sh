@@ -0,0 +1,34 @@
+# Time `cut -d, -f3,7` over a generated 40 column CSV file, run by `meson test --benchmark`. In a
+# single byte locale the builtin scans for delimiters a word at a time. In a UTF-8 locale it still
+# steps through one character at a time like the single byte scan it replaced, so that run is the
+# baseline. An optional argument sets the number of lines.
+builtin cut || exit 1
+integer lines=${1:-500000} i
+tmp=$(mktemp -dt ksh.cutbench.XXXXXX) || exit 1
+trap 'rm -rf "$tmp"' EXIT
+
+row=
+for ((i = 1; i <= 40; i++))
+do
+    row+="field$i-$((i * 7919 % 1000)),"
+done
+row=${row%,}
+for ((i = 0; i < 1000; i++))
+do
+    print -r -- "$i,$row"
+done > "$tmp/block"
+for ((i = 0; i < lines / 1000; i++))
+do
+    cat "$tmp/block"
+done > "$tmp/data.csv"
+
+function run # locale description
+{
+    typeset -F3 start=SECONDS
+    (export LC_ALL=$1; cut -d, -f3,7 "$tmp/data.csv" > "$tmp/out.$1")
+    printf '%-28s %d lines %.3fs\n' "$2" lines SECONDS-start
+}
+
+run C 'cut -d, -f3,7 word scan'
+run C.UTF-8 'cut -d, -f3,7 per character'
+cmp -s "$tmp/out.C" "$tmp/out.C.UTF-8" || { print -u2 'cut output differs between locales'; exit 1; }
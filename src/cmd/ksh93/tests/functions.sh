@@ -1335,3 +1335,44 @@ $SHELL -c 'function ftest { ftest2; }; function ftest2 { unset -f ftest; }; ftes
 function f2 { env | grep -q "^foo" || log_error "Environment variable is not propogated from caller function"; }
 function f1 { f2; env | grep -q "^foo" || log_error "Environment variable is not passed to a function"; }
 foo=bar f1
+
+# Function scopes are reused and the caller's traps survive calls that change them.
+actual=$($SHELL -c '
+    function settraps { trap "print inner" USR1; trap - USR2; trap "" HUP; typeset x=$1; }
+    function plain { typeset y=$1; }
+    trap "print outer" USR1
+    trap "" USR2
+    integer i hits=${.sh.stats.scope_cachehit}
+    for ((i = 0; i < 100; i++))
+    do
+        settraps $i
+        plain $i
+    done
+    (( ${.sh.stats.scope_cachehit} - hits >= 199 )) || print "scopes not reused"
+    trap
+    kill -USR1 $$
+    kill -USR2 $$
+    print done
+')
+expect=$'trap -- \'\' USR2\ntrap -- \'print outer\' USR1\nouter\ndone'
+[[ $actual == "$expect" ]] || log_error "traps are not restored after function calls" "$expect" "$actual"
+
+# Names resolve the same way however deeply functions nest.
+actual=$($SHELL -c '
+    g=global x=outer
+    function deep {
+        typeset x=$1
+        if (( x < 200 ))
+        then
+            deep $((x + 1))
+        else
+            print -r -- "$g ${x} ${y-unset}"
+        fi
+        typeset y=$x
+    }
+    function caller { typeset y=caller; deep 1; }
+    caller
+    print -r -- "$x ${y-unset}"
+')
+expect=$'global 200 unset\nouter unset'
+[[ $actual == "$expect" ]] || log_error "name lookup wrong in deeply nested functions" "$expect" "$actual"
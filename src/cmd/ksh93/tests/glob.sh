@@ -199,6 +199,26 @@ test_glob '<man/man1/sh.1>' */man*/sh.*
 test_glob '<man/man1/sh.1>' $(echo */man*/sh.*)
 test_glob '<man/man1/sh.1>' "$(echo */man*/sh.*)"
 
+# Directory entry types stand in for stat() and must give the same results.
+mkdir -p tree/d1/d2 tree/d3
+touch tree/f1 tree/d1/f2 tree/d1/d2/f3
+ln -s d1 tree/l1
+ln -s nowhere tree/l2
+
+test_glob '<tree/d1/> <tree/d3/> <tree/l1/>' tree/*/
+test_glob '<tree/d1/f2> <tree/l1/f2>' tree/*/f2
+set -o markdirs
+test_glob '<tree/d1/> <tree/d3/> <tree/f1> <tree/l1/> <tree/l2>' tree/*
+set +o markdirs
+set -o globstar
+test_glob '<tree/d1/d2/f3> <tree/d1/f2> <tree/f1>' tree/**/f?
+set +o globstar
+
+integer nostat=${.sh.stats.globs_nostat}
+: tree/*/*
+(( ${.sh.stats.globs_nostat} > nostat )) || log_error "globs should use directory entry types"
+rm -rf tree
+
 test_case '<match>' 'abc' 'a***c'
 test_case '<match>' 'abc' 'a*****?c'
 test_case '<match>' 'abc' '?*****??'
@@ -29,3 +29,19 @@ if [[ $LC_ALL == en_US.UTF-8 ]]
     actual=$(IFS=é; set : :; echo "$*"; trap "echo end" EXIT; trap)
     [[ "$expect" == "$actual" ]] || log_error "IFS subshell failed" "$expect" "$actual"
 fi
+
+# Runs of ordinary characters between separators are copied in one piece.
+unset IFS
+x=$(for ((i = 0; i < 5000; i++)); do print -rn -- "word$i  é$i"$'\t\n' " x*$i "; done)
+set -f -- $x
+set +f
+(($# == 15000)) || log_error "splitting a large expansion gives the wrong field count" 15000 "$#"
+[[ $1 == word0 && $2 == é0 && $3 == 'x*0' && ${@: -1} == 'x*4999' ]] ||
+    log_error "splitting a large expansion gives the wrong fields" "word0 é0 x*0 x*4999" "$1 $2 $3 ${@: -1}"
+IFS=:
+x=$(for ((i = 0; i < 5000; i++)); do print -rn -- "a $i::"; done)
+set -- $x
+unset IFS
+(($# == 10000)) || log_error "splitting on a non-white separator gives the wrong count" 10000 "$#"
+[[ $1 == 'a 0' && $2 == '' && ${@: -1} == '' && ${@: -2:1} == 'a 4999' ]] ||
+    log_error "splitting on a non-white separator gives the wrong fields"
@@ -432,3 +432,83 @@ cat < /dev/null || log_error "Directories should not be treated as executables"
 
 # Restore PATH
 PATH="$OPATH"
+
+# Commands added to or removed from $PATH directories must be noticed right away.
+mkdir -p $TEST_DIR/pidx1 $TEST_DIR/pidx2
+PATH=$TEST_DIR/pidx1:$TEST_DIR/pidx2:$OPATH
+pidxcmd 2> /dev/null && log_error 'pidxcmd should not be found'
+print $'#!/bin/sh\necho pidx2' > $TEST_DIR/pidx2/pidxcmd
+chmod +x $TEST_DIR/pidx2/pidxcmd
+[[ $(pidxcmd) == pidx2 ]] || log_error 'command just added to $PATH directory not found'
+print $'#!/bin/sh\necho pidx1' > $TEST_DIR/pidx1/pidxcmd
+chmod +x $TEST_DIR/pidx1/pidxcmd
+hash -r
+[[ $(pidxcmd) == pidx1 ]] || log_error 'command added earlier in $PATH not found'
+# A command added in front of one that was just found is found after `hash -r` or an assignment
+# to PATH, even when the directory indexes were checked less than a second before.
+for lookup in 'hash -r; pidxcmd' 'PATH=$PATH; pidxcmd' 'hash -r; (pidxcmd)' 'hash -r; print $(pidxcmd)'
+do
+    rm $TEST_DIR/pidx1/pidxcmd
+    touch -t 200001010000 $TEST_DIR/pidx1 $TEST_DIR/pidx2
+    hash -r
+    [[ $(pidxcmd) == pidx2 ]] || log_error 'command removed from $PATH directory still found'
+    pidxcmd > /dev/null
+    print $'#!/bin/sh\necho pidx1' > $TEST_DIR/pidx1/pidxcmd
+    chmod +x $TEST_DIR/pidx1/pidxcmd
+    eval "$lookup" > "$TEST_DIR/pidxout"
+    got=$(< "$TEST_DIR/pidxout")
+    [[ $got == pidx1 ]] || log_error "command added earlier in \$PATH not found by '$lookup'" pidx1 "$got"
+done
+rm $TEST_DIR/pidx1/pidxcmd $TEST_DIR/pidx2/pidxcmd
+hash -r
+pidxcmd 2> /dev/null && log_error 'removed pidxcmd should not be found'
+PATH="$OPATH"
+
+# The command resolution cache must follow function definitions, PATH changes and builtin -f/-d.
+mkdir -p $TEST_DIR/pcmd
+print 'print pcmd' > $TEST_DIR/pcmd/pcmdcmd
+chmod +x $TEST_DIR/pcmd/pcmdcmd
+PATH=$TEST_DIR/pcmd:$OPATH
+cmd=pcmdcmd
+for i in 1 2 3
+do  [[ $($cmd) == pcmd ]] || log_error "pcmdcmd not found on pass $i"
+done
+(( ${.sh.stats.cmd_cachehit} > 0 )) || log_error 'repeated commands should be resolved from the cache'
+function pcmdcmd { print fun; }
+[[ $($cmd) == fun ]] || log_error 'function defined after command was cached not used'
+[[ $(function pcmdcmd { print subfun; }; $cmd) == subfun ]] ||
+    log_error 'function defined in subshell not used'
+[[ $($cmd) == fun ]] || log_error 'function defined in subshell is still used'
+unset -f pcmdcmd
+[[ $($cmd) == pcmd ]] || log_error 'command not used after function was unset'
+PATH=$OPATH
+$cmd > /dev/null 2>&1 && log_error 'pcmdcmd found after it was removed from PATH'
+PATH=$TEST_DIR/pcmd:$OPATH
+[[ $($cmd) == pcmd ]] || log_error 'pcmdcmd not found after PATH was restored'
+if builtin -f cmd basename 2> /dev/null || builtin basename 2> /dev/null
+then
+    cmd=basename
+    [[ $($cmd /x/y) == y ]] || log_error 'basename builtin does not work'
+    builtin -d basename
+    [[ $(type $cmd) == *builtin* ]] && log_error 'builtin -d does not delete basename'
+fi
+PATH="$OPATH"
+
+# Without job control simple commands found on PATH are started with posix_spawn().
+PATH=$TEST_DIR/pcmd:$OPATH
+integer spawns=${.sh.stats.spawns}
+for i in 1 2 3
+do  actual=$(env printf x%s $i)
+    [[ $actual == x$i ]] || log_error "spawned command output wrong on pass $i" "x$i" "$actual"
+done
+actual=$(env)
+[[ $actual == *$'\n'_=\*+([0-9])\*/*env* || $actual == _=\*+([0-9])\*/*env* ]] ||
+    log_error 'spawned command environment should contain _'
+actual=$(pcmdcmd)
+[[ $actual == pcmd ]] || log_error 'script without #! not run after spawn failed' pcmd "$actual"
+actual=$(exec <&- 2>&1; cat)
+[[ $actual == '' ]] || log_error 'spawned command should get /dev/null for closed stdin' '' "$actual"
+actual=$(trap '' USR1; $SHELL -c 'kill -USR1 $$; print survived')
+[[ $actual == survived ]] || log_error 'ignored signals should stay ignored in spawned commands'
+(( ${.sh.stats.spawns} > spawns )) || log_error 'simple commands should be spawned'
+PATH="$OPATH"
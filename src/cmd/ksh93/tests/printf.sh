@@ -84,6 +84,17 @@ do
 done
 [[ "$actual" == "$expect" ]] || log_error 'printf "%T" now wrong output' "$expect" "$actual"
 
+# Repeated times are converted again when the format or time zone changes.
+actual=$(printf '%(%H:%M)T %(%H)T %(%H:%M)T\n' '#0' '#0' '#0' '#3660' '#3660' '#7200')
+expect=$'00:00 00 00:00\n01:01 01 02:00'
+[[ "$actual" == "$expect" ]] || log_error 'printf %T of repeated times wrong' "$expect" "$actual"
+actual=$(for tz in UTC JST-9 UTC; do TZ=$tz printf '%(%Z)T,' '#0'; done)
+expect='UTC,JST,UTC,'
+[[ "$actual" == "$expect" ]] || log_error 'printf %T ignores time zone changes' "$expect" "$actual"
+actual=$(for tz in UTC JST-9 EST5EDT UTC; do TZ=$tz printf '%(%H:%M %Z)T,' '#1700000000'; done)
+expect='22:13 UTC,07:13 JST,17:13 EST,22:13 UTC,'
+[[ "$actual" == "$expect" ]] || log_error 'printf %T keeps the first UTC offset' "$expect" "$actual"
+
 # %Z     A %Z format will output a byte whose value is 0.
 printf "%Z" | od | head -n1 | grep -q "000000 *$" || log_error "printf %Z does not output null byte"
 
@@ -203,3 +203,40 @@ read baz <<< 'foo\\\\bar'
 
 printf '\\\000' | read -r -d ''
 [[ $REPLY == $'\\' ]] || log_error "read -r -d'' ignores -r"
+
+# ==========
+# read -L reads a batch of records into an indexed array.
+integer i n=0
+for ((i = 1; i <= 2500; i++))
+do
+    print "record $i"
+done > $TEST_DIR/records
+typeset -a batch=(stale stale stale)
+while read -L 1000 batch
+do
+    for ((i = 0; i < ${#batch[@]}; i++))
+    do
+        [[ ${batch[i]} == "record $((n + i + 1))" ]] ||
+            log_error "read -L record $((n + i + 1)) is wrong" "record $((n + i + 1))" "${batch[i]}"
+    done
+    ((n += ${#batch[@]}))
+done < $TEST_DIR/records
+((n == 2500)) || log_error "read -L read the wrong number of records" 2500 "$n"
+((${#batch[@]} == 0)) || log_error "read -L at end of file should leave an empty array"
+
+printf 'a  b\nc\\\n\nlast' | {
+    read -L 10 batch
+    status=$?
+    actual=$(typeset -p batch)
+}
+expect="typeset -a batch=('a  b' 'c\\' '' last)"
+[[ $status == 0 && $actual == "$expect" ]] ||
+    log_error "read -L of an incomplete last record failed" "$expect" "$actual"
+
+actual=$(print $'one\ntwo\nthree\nfour' | { read -L 2 pair; read line; cat; print ${pair[1]} $line; })
+expect=$'four\ntwo three'
+[[ $actual == "$expect" ]] || log_error "read -L reads ahead on a pipe" "$expect" "$actual"
+
+read -L 5 -d , batch <<< "x,y,z"
+[[ ${#batch[@]} == 3 && ${batch[2]} == $'z\n' ]] ||
+    log_error "read -L -d , failed" "3 z" "${#batch[@]} ${batch[2]}"
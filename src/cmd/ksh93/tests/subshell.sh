@@ -856,3 +856,27 @@ for exp in 65535 65536
 do    got=$($SHELL -c 'x=$(printf "%.*c" '$exp' x); print ${#x}' 2>&1)
     [[ $got == $exp ]] || log_error "large command substitution failed" "$exp" "$got"
 done
+
+# Each variable is saved only once per subshell no matter how often it is assigned, and nested
+# subshells restore the values of the enclosing subshell.
+unset v0 v1 v2
+integer saves=${.sh.stats.subshell_saves}
+(
+    for ((i = 0; i < 100; i++))
+    do
+        v0=$i v1=$i v2=$i
+    done
+    (v1=inner; v2=inner)
+    [[ $v0 == 99 && $v1 == 99 && $v2 == 99 ]] || log_error "nested subshell did not restore values"
+)
+[[ -z $v0$v1$v2 ]] || log_error "subshell assignments not restored" "" "$v0$v1$v2"
+(( (${.sh.stats.subshell_saves} - saves) < 10 )) ||
+    log_error "subshell saved variables more than once" "< 10" "$(( ${.sh.stats.subshell_saves} - saves ))"
+
+# A command substitution of an external command streams its output through a pipe. Make sure
+# large output, trailing newlines and the exit status survive.
+got=$(/bin/sh -c 'i=0; while [ $i -lt 20000 ]; do echo 0123456789; i=$((i + 1)); done; echo; echo')
+(( ${#got} == 219999 )) || log_error "streamed command substitution lost data" 219999 "${#got}"
+got=$(/bin/sh -c 'echo out; exit 3')
+status=$?
+[[ $got == out && $status == 3 ]] || log_error "streamed command substitution failed" "out 3" "$got $status"
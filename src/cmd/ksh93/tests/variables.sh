@@ -831,3 +831,40 @@ actual="${.sh.file}"
 actual="$(pwd -f ${.sh.pwdfd})"
 expect="$PWD"
 [[ "$actual" = "$expect" ]] || log_error ".sh.pwdfd should point to fd of current working directory"
+
+# The environment passed to external commands must track every change to exported variables.
+export envfoo=a
+env > envout
+grep -qx envfoo=a envout || log_error 'exported variable not in environment'
+envfoo=b
+env > envout
+grep -qx envfoo=b envout || log_error 'environment not updated after assignment'
+typeset -u envfoo
+env > envout
+grep -qx envfoo=B envout || log_error 'environment not updated after typeset -u'
+function envfn { typeset envfoo=local; env > envout; }
+envfn
+grep -q '^envfoo=' envout && log_error 'local variable should hide exported variable from environment'
+(export envbar=1; env > /dev/null)
+env > envout
+grep -q '^envbar=' envout && log_error 'subshell export leaked into environment'
+typeset +x envfoo
+env > envout
+grep -q '^envfoo=' envout && log_error 'environment not updated after typeset +x'
+unset envfoo
+
+# Variable lookups are cached by name and scope. A loop over more names than the cache held
+# originally should still mostly hit and local variables must not resolve to stale entries.
+for v in va vb vc vd ve vf vg vh vi vj vk vl vm vn vo vp; do eval "$v=0"; done
+integer hits=${.sh.stats.nv_cachehit} misses=${.sh.stats.nv_cachemiss}
+for ((i=0; i < 50; i++)); do
+    va=1 vb=1 vc=1 vd=1 ve=1 vf=1 vg=1 vh=1 vi=1 vj=1 vk=1 vl=1 vm=1 vn=1 vo=1 vp=1
+done
+(( (${.sh.stats.nv_cachehit} - hits) > 10 * (${.sh.stats.nv_cachemiss} - misses) )) ||
+    log_error 'variable lookup cache hit rate too low' \
+        "hits $((${.sh.stats.nv_cachehit} - hits))" "misses $((${.sh.stats.nv_cachemiss} - misses))"
+function cachefn { typeset va=local; va=$1; print -r -- "$va"; }
+va=global
+cachefn one > /dev/null
+[[ $(cachefn two) == two && $va == global ]] || log_error 'cached lookup resolved to the wrong scope'
+unset va vb vc vd ve vf vg vh vi vj vk vl vm vn vo vp hits misses
@@ -68,3 +68,19 @@ expect=$"      33 $TEST_DIR/file2"
 actual=$(wc -N "$TEST_DIR/file2")
 expect="       7      38     158 $TEST_DIR/file2"
 [[ "$actual" = "$expect" ]] || log_error "'wc -N' failed" "$expect" "$actual"
+
+# ==========
+# Lines and words are counted the same wherever they fall in the 8 byte blocks read at a time.
+for ((i=0; i < 300; i++))
+do  print -n -- "${i:0:i%4} ${i}x"$'\t'"$((i%7))"$'\v\f\r'
+    ((i % 5)) || print
+done > "$TEST_DIR/file3"
+actual=$(LC_ALL=C wc -lwc < "$TEST_DIR/file3")
+expect="      60     825    3371"
+[[ "$actual" = "$expect" ]] || log_error "'wc -lwc' of mixed white space failed" "$expect" "$actual"
+for i in 1 2 3 4 5 6 7 8 9
+do  actual=$(print -n -- "${.sh.version:0:i}"$'\n' | LC_ALL=C wc -lw)
+    expect=$(print -n -- "${.sh.version:0:i}"$'\n' | LC_ALL=C command -p wc -lw)
+    [[ "${actual// /}" = "${expect//[[:space:]]/}" ]] ||
+        log_error "'wc -lw' of $i bytes failed" "$expect" "$actual"
+done
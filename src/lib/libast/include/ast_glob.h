@@ -102,7 +102,9 @@ struct _glob_ {
     unsigned long gl_starstar;
     char *gl_opt;
     char *gl_pat;
-    char *gl_pad[4];
+    int gl_dirtype;
+    unsigned long gl_nostat;
+    char *gl_pad[2];
 };
 
 /* standard interface */
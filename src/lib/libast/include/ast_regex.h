@@ -176,6 +176,14 @@ typedef struct regstat_s {
     regflags_t re_info;  /* REG_* info                  */
 } regstat_t;
 
+typedef struct regcachestat_s {
+    unsigned long hits;      /* regcache() lookups found    */
+    unsigned long misses;    /* regcache() lookups compiled */
+    unsigned long evictions; /* lru re's freed for new ones */
+    unsigned int count;      /* # cached re's               */
+    unsigned int size;       /* max # cached re's           */
+} regcachestat_t;
+
 struct regex_s {
     size_t re_nsub;           /* number of subexpressions       */
     struct reglib_s *re_info; /* library private info           */
@@ -208,6 +216,7 @@ extern int regrexec(const regex_t *, const char *, size_t, size_t, regmatch_t *,
                     void *, regrecord_t);
 extern regstat_t *regstat(const regex_t *);
 extern regex_t *regcache(const char *, regflags_t, int *);
+extern regcachestat_t *regcachestat(void);
 extern int regsubflags(regex_t *, const char *, char **, int, const regflags_t *, int *,
                        regflags_t *);
 extern void regsubfree(regex_t *);
@@ -69,6 +69,7 @@ typedef struct Optcache_s {
     Optpass_t pass;
     int caching;
     unsigned char flags[sizeof(OPT_FLAGS)];
+    unsigned char alias[sizeof(OPT_FLAGS)];
 } Optcache_t;
 
 typedef struct Optstate_s {
@@ -30,12 +30,14 @@
 
 #include <dirent.h>
 #include <errno.h>
+#include <fcntl.h>
 #include <stdbool.h>
 #include <stddef.h>
 #include <string.h>
 #include <sys/stat.h>
 
 #include "ast.h"
+#include "ast_dir.h"
 #include "ast_glob.h"
 #include "ast_regex.h"
 #include "sfio.h"
@@ -46,6 +48,7 @@
 #define MATCH_RAW 1
 #define MATCH_MAKE 2
 #define MATCH_META 4
+#define MATCH_DIR 8 /* gl_path known to be a directory, not a symlink */
 
 #define MATCHPATH(g) (offsetof(globlist_t, gl_path) + (g)->gl_extra)
 
@@ -64,8 +67,21 @@ static_fn char *gl_dirnext(glob_t *gp, DIR *handle) {
 
     if (!dp) return NULL;
 #ifdef D_TYPE
-    if (D_TYPE(dp) != DT_UNKNOWN && D_TYPE(dp) != DT_DIR && D_TYPE(dp) != DT_LNK) {
-        gp->gl_status |= GLOB_NOTDIR;
+    switch (D_TYPE(dp)) {
+        case DT_UNKNOWN:
+        case DT_LNK:
+            break;
+        case DT_DIR:
+            gp->gl_dirtype = GLOB_DIR;
+            break;
+        case DT_REG:
+            gp->gl_dirtype = GLOB_REG;
+            gp->gl_status |= GLOB_NOTDIR;
+            break;
+        default:
+            gp->gl_dirtype = GLOB_DEV;
+            gp->gl_status |= GLOB_NOTDIR;
+            break;
     }
 #endif
     return dp->d_name;
@@ -77,6 +93,21 @@ static_fn char *gl_dirnext(glob_t *gp, DIR *handle) {
 
 static_fn int gl_dirclose(glob_t *gp, DIR *handle) { return (gp->gl_closedir)(handle); }
 
+//
+// Map a file mode to a gl_type() return value.
+//
+static_fn int gl_modetype(mode_t mode) {
+    if (S_ISDIR(mode)) {
+        return GLOB_DIR;
+    } else if (!S_ISREG(mode)) {
+        return GLOB_DEV;
+    } else if (mode & (S_IXUSR | S_IXGRP | S_IXOTH)) {
+        return GLOB_EXE;
+    }
+
+    return GLOB_REG;
+}
+
 //
 // Default gl_type.
 //
@@ -86,16 +117,7 @@ static_fn int gl_type(glob_t *gp, const char *path, int flags) {
     memset(&st, 0, sizeof(st));
     int stat_rv = (flags & GLOB_STARSTAR) ? (*gp->gl_lstat)(path, &st) : (*gp->gl_stat)(path, &st);
     if (stat_rv == -1) return 0;
-
-    if (S_ISDIR(st.st_mode)) {
-        return GLOB_DIR;
-    } else if (!S_ISREG(st.st_mode)) {
-        return GLOB_DEV;
-    } else if (st.st_mode & (S_IXUSR | S_IXGRP | S_IXOTH)) {
-        return GLOB_EXE;
-    }
-
-    return GLOB_REG;
+    return gl_modetype(st.st_mode);
 }
 
 /*
@@ -172,8 +194,32 @@ static_fn void glob_trim(char *sp, char *p1, int *n1, char *p2, int *n2) {
     } while (c);
 }
 
+//
+// Return the gl_type() of the directory entry just added to the stack. `known` is the type
+// gl_dirnext() got from the directory entry, 0 if unknown. If `fd` is the open directory
+// holding `name` and the default gl_stat is in effect then stat relative to it rather than
+// have the kernel walk the full path again.
+//
+static_fn int glob_type(glob_t *gp, int fd, const char *name, int known) {
+    struct stat st;
+
+    if (known && (known != GLOB_REG || !(gp->gl_flags & GLOB_COMPLETE))) {
+        gp->gl_nostat++;
+        return known;
+    }
+    if (fd >= 0) {
+        int old_errno = errno;
+        if (!fstatat(fd, name, &st, 0)) return gl_modetype(st.st_mode);
+        errno = old_errno;
+        if (!fstatat(fd, name, &st, AT_SYMLINK_NOFOLLOW)) return gl_modetype(st.st_mode);
+        errno = old_errno;
+        return 0;
+    }
+    return (*gp->gl_type)(gp, stkptr(stkstd, MATCHPATH(gp)), 0);
+}
+
 static_fn void glob_addmatch(glob_t *gp, const char *dir, const char *pat, const char *rescan,
-                             char *endslash, int meta) {
+                             char *endslash, int meta, int fd, int known) {
     globlist_t *ap;
     int offset;
     int type;
@@ -188,7 +234,8 @@ static_fn void glob_addmatch(glob_t *gp, const char *dir, const char *pat, const
     sfputr(stkstd, pat, 0);
     --stkstd->next;
     if (rescan) {
-        if ((*gp->gl_type)(gp, stkptr(stkstd, MATCHPATH(gp)), 0) != GLOB_DIR) return;
+        if (glob_type(gp, fd, pat, known) != GLOB_DIR) return;
+        if (known == GLOB_DIR) meta |= MATCH_DIR;
         sfputc(stkstd, gp->gl_delim);
         offset = stktell(stkstd);
         /* if null, reserve room for . */
@@ -206,7 +253,7 @@ static_fn void glob_addmatch(glob_t *gp, const char *dir, const char *pat, const
         gp->gl_rescan = ap;
     } else {
         if (!endslash && (gp->gl_flags & GLOB_MARK) &&
-            (type = (*gp->gl_type)(gp, stkptr(stkstd, MATCHPATH(gp)), 0))) {
+            (type = glob_type(gp, fd, pat, known))) {
             if ((gp->gl_flags & GLOB_COMPLETE) && type != GLOB_EXE) {
                 stkseek(stkstd, 0);
                 return;
@@ -243,6 +290,8 @@ static_fn void glob_dir(glob_t *gp, globlist_t *ap, int re_flags) {
     regex_t rec;
     regex_t rei;
     int notdir;
+    int type;
+    int fd;
     int t1;
     int t2;
     int bracket;
@@ -259,6 +308,7 @@ static_fn void glob_dir(glob_t *gp, globlist_t *ap, int re_flags) {
     regex_t *prei = NULL;
     char *matchdir = NULL;
     int starstar = 0;
+    bool isdir = false;
 
     if (*gp->gl_intr) {
         gp->gl_error = GLOB_INTR;
@@ -287,10 +337,12 @@ again:
                     *(rescan - 2) = 0;
                     c = (*gp->gl_type)(gp, prefix, 0);
                     *(rescan - 2) = gp->gl_delim;
-                    if (c == GLOB_DIR) glob_addmatch(gp, NULL, prefix, NULL, rescan - 1, anymeta);
+                    if (c == GLOB_DIR) {
+                        glob_addmatch(gp, NULL, prefix, NULL, rescan - 1, anymeta, -1, 0);
+                    }
                 } else if ((anymeta || !(gp->gl_flags & GLOB_NOCHECK)) &&
                            (*gp->gl_type)(gp, prefix, 0)) {
-                    glob_addmatch(gp, NULL, prefix, NULL, NULL, anymeta);
+                    glob_addmatch(gp, NULL, prefix, NULL, NULL, anymeta, -1, 0);
                 }
                 return;
             case '[':
@@ -341,6 +393,7 @@ again:
         }
     } else {
         if (pat == prefix + 1) dirname = "/";
+        isdir = (ap->gl_flags & MATCH_DIR) && pat == ap->gl_begin && !savequote;
         if (savequote) {
             quote = 0;
             glob_trim(ap->gl_begin, pat, &t1, rescan, &t2);
@@ -390,9 +443,14 @@ skip:
             if (!(dirname = (*gp->gl_nextdir)(gp, dirname))) break;
             prefix = !strcmp(dirname, ".") ? NULL : dirname;
         }
-        if (((!starstar && !gp->gl_starstar) ||
+        if (((!starstar && !gp->gl_starstar) || (isdir && ++gp->gl_nostat) ||
              (*gp->gl_type)(gp, dirname, GLOB_STARSTAR) == GLOB_DIR) &&
             (dirf = (*gp->gl_diropen)(gp, dirname))) {
+            fd = -1;
+            if (gp->gl_diropen == gl_diropen && gp->gl_opendir == opendir &&
+                gp->gl_type == gl_type && gp->gl_stat == pathstat) {
+                fd = dirfd((DIR *)dirf);
+            }
             if (!(gp->re_flags & REG_ICASE) && ((*gp->gl_attr)(gp, dirname, 0) & GLOB_ICASE)) {
                 if (!prei) {
                     err = regcomp(&rei, pat, gp->re_flags | REG_ICASE);
@@ -427,23 +485,27 @@ skip:
                 ire = gp->gl_ignorei;
             }
             if (restore2) *restore2 = gp->gl_delim;
-            while ((name = (*gp->gl_dirnext)(gp, dirf)) && !*gp->gl_intr) {
+            while ((gp->gl_dirtype = 0, name = (*gp->gl_dirnext)(gp, dirf)) && !*gp->gl_intr) {
                 // If FIGNORE is set, ignore `.` and `..`.
                 // https://github.com/att/ast/issues/11
                 if (gp->gl_fignore && (!strcmp(name, ".") || !strcmp(name, ".."))) {
                     continue;
                 }
+                type = gp->gl_dirtype;
                 notdir = (gp->gl_status & GLOB_NOTDIR);
                 if (notdir) gp->gl_status &= ~GLOB_NOTDIR;
                 if (ire && !regexec(ire, name, 0, NULL, 0)) continue;
                 if (matchdir && (name[0] != '.' || (name[1] && (name[1] != '.' || name[2]))) &&
                     !notdir) {
-                    glob_addmatch(gp, prefix, name, matchdir, NULL, anymeta);
+                    glob_addmatch(gp, prefix, name, matchdir, NULL, anymeta, fd, type);
                 }
                 if (!regexec(pre, name, 0, NULL, 0)) {
-                    if (!rescan || !notdir) glob_addmatch(gp, prefix, name, rescan, NULL, anymeta);
+                    if (!rescan || !notdir) {
+                        glob_addmatch(gp, prefix, name, rescan, NULL, anymeta, fd, type);
+                    }
                     if (starstar == 1 || (starstar == 2 && !notdir)) {
-                        glob_addmatch(gp, prefix, name, starstar == 2 ? "" : NULL, NULL, anymeta);
+                        glob_addmatch(gp, prefix, name, starstar == 2 ? "" : NULL, NULL, anymeta,
+                                      fd, type);
                     }
                 }
                 errno = 0;
@@ -3914,6 +3914,7 @@ again:
             if (cache) {
                 k = cache->flags[map[c]];
                 if (k) {
+                    if (cache->alias[map[c]]) c = cache->alias[map[c]];
                     opt_info.arg = 0;
 
                     /*
@@ -4304,7 +4305,11 @@ again:
                                     break;
                                 }
                                 cache->flags[map[j]] = m;
+                                if (!isdigit(*v) || !isdigit(*(v + 1))) {
+                                    cache->alias[map[j]] = *v;
+                                }
                             }
+                            if (*(f + 1) == '!') j = '!';
                             if (j != '!' || (m & OPT_cache_invert)) break;
                             f = v;
                             m |= OPT_cache_invert;
@@ -83,6 +83,12 @@
 
 #define STK_HDRSIZE (sizeof(Sfio_t) + sizeof(Sfdisc_t))
 
+// Freed frames of up to STK_CLASSES pages are kept on a free list for each size so that stacks
+// which are opened and closed in bulk, such as those holding function definitions, reuse them
+// rather than going back to malloc().
+#define STK_CLASSES 4
+#define STK_CACHE 32  // max frames kept for each size
+
 typedef char *(*_stk_overflow_)(int);
 
 static_fn int stkexcept(Sfio_t *, int, void *, Sfdisc_t *);
@@ -107,6 +113,8 @@ struct stk {
 
 static size_t init;         // 1 when initialized
 static struct stk *stkcur;  // pointer to current stk
+static struct frame *stkcache[STK_CLASSES];  // free frames by size in pages
+static int stkncache[STK_CLASSES];           // number of frames on each free list
 static_fn char *stkgrow(Sfio_t *, size_t);
 
 #define stream2stk(stream) \
@@ -125,6 +133,8 @@ static struct {
     int seek;
     int set;
     int grow;
+    int reuse;
+    int cache;
     int addsize;
     int delsize;
     int movsize;
@@ -149,6 +159,40 @@ static_fn char *overflow(int n) {
     return 0;
 }
 
+//
+// Allocate a frame of <n> bytes, from the free list for its size if possible
+//
+static_fn void *stkframe(size_t n) {
+    int c = n / STK_FSIZE - 1;
+    struct frame *fp;
+
+    if (n % STK_FSIZE == 0 && c >= 0 && c < STK_CLASSES && (fp = stkcache[c])) {
+        increment(reuse);
+        stkcache[c] = (struct frame *)fp->prev;
+        stkncache[c]--;
+        return fp;
+    }
+    return malloc(n);
+}
+
+//
+// Free frame <fp>, keeping it on the free list for its size if there is room
+//
+static_fn void stkfree(struct frame *fp) {
+    size_t n = fp->end - (char *)fp;
+    int c = n / STK_FSIZE - 1;
+
+    if (!fp->nalias && n % STK_FSIZE == 0 && c >= 0 && c < STK_CLASSES &&
+        stkncache[c] < STK_CACHE) {
+        increment(cache);
+        fp->prev = (char *)stkcache[c];
+        stkcache[c] = fp;
+        stkncache[c]++;
+        return;
+    }
+    free(fp);
+}
+
 //
 // Initialize stkstd, sfio operations may have already occcured
 //
@@ -177,9 +221,9 @@ static_fn int stkexcept(Sfio_t *stream, int type, void *val, Sfdisc_t *dp) {
                         fp = (struct frame *)cp;
                         if (fp->prev) {
                             cp = fp->prev;
-                            free(fp);
+                            stkfree(fp);
                         } else {
-                            free(fp);
+                            stkfree(fp);
                             break;
                         }
                     }
@@ -239,11 +283,12 @@ Sfio_t *stkopen(int flags) {
     }
     bsize = init + sizeof(struct frame);
     bsize = roundof(bsize, STK_FSIZE);
-    fp = calloc(1, bsize);
+    fp = stkframe(bsize);
     if (!fp) {
         free(stream);
         return NULL;
     }
+    memset(fp, 0, bsize);
     bsize -= sizeof(struct frame);
     count(addsize, sizeof(*fp) + bsize);
     cp = (char *)(fp + 1);
@@ -355,7 +400,7 @@ char *stkset(Sfio_t *stream, char *loc, size_t offset) {
         if (fp->prev) {
             sp->stkbase = fp->prev;
             sp->stkend = ((struct frame *)(fp->prev))->end;
-            free(fp);
+            stkfree(fp);
         } else {
             break;
         }
@@ -479,7 +524,7 @@ static_fn char *stkgrow(Sfio_t *stream, size_t size) {
         endoff = end - dp;
         sp->stkbase = ((struct frame *)dp)->prev;
     }
-    cp = realloc(dp, n + nn * sizeof(char *));
+    cp = dp ? realloc(dp, n + nn * sizeof(char *)) : stkframe(n);
     if (!cp && (!sp->stkoverflow || !(cp = (*sp->stkoverflow)(n)))) return 0;
     increment(grow);
     count(addsize, n - (dp ? m : 0));
@@ -32,56 +32,138 @@
 #include "ast.h"
 #include "ast_regex.h"
 
-#define CACHE 8  /* default # cached re's       */
-#define ROUND 64 /* pattern buffer size round   */
+#define CACHE 64 /* default # cached re's       */
 
-typedef unsigned long Key_t;
+/*
+ * the cached re's are chained in hash buckets keyed on the pattern,
+ * reflags and locale and are kept on a list in least recently used order
+ */
 
 typedef struct Cache_s {
+    struct Cache_s *next;  /* next in hash bucket         */
+    struct Cache_s *newer; /* next more recently used     */
+    struct Cache_s *older; /* next less recently used     */
     char *pattern;
+    char *locale;
     regex_t re;
-    unsigned long serial;
     regflags_t reflags;
-    int keep;
-    int size;
+    unsigned int hash;
 } Cache_t;
 
 typedef struct State_s {
-    unsigned int size;
-    unsigned long serial;
-    char *locale;
-    Cache_t **cache;
+    unsigned int size; /* max # cached re's           */
+    unsigned int mask; /* hash table size - 1         */
+    Cache_t **table;
+    Cache_t *newest;
+    Cache_t *oldest;
+    regcachestat_t stats;
 } State_t;
 
 static State_t matchstate;
 
+/*
+ * remove cp from the lru list
+ */
+
+static_fn void regex_detach(Cache_t *cp) {
+    if (cp->newer) {
+        cp->newer->older = cp->older;
+    } else {
+        matchstate.newest = cp->older;
+    }
+    if (cp->older) {
+        cp->older->newer = cp->newer;
+    } else {
+        matchstate.oldest = cp->newer;
+    }
+}
+
+/*
+ * remove cp from its hash bucket and the lru list
+ */
+
+static_fn void regex_unlink(Cache_t *cp) {
+    Cache_t **pp;
+
+    for (pp = &matchstate.table[cp->hash & matchstate.mask]; *pp != cp; pp = &(*pp)->next) {
+        ;  // empty loop
+    }
+    *pp = cp->next;
+    regex_detach(cp);
+    matchstate.stats.count--;
+}
+
+/*
+ * make cp the most recently used entry
+ */
+
+static_fn void regex_touch(Cache_t *cp) {
+    cp->older = matchstate.newest;
+    cp->newer = NULL;
+    if (matchstate.newest) {
+        matchstate.newest->newer = cp;
+    } else {
+        matchstate.oldest = cp;
+    }
+    matchstate.newest = cp;
+}
+
+/*
+ * remove cp from the cache and free it
+ */
+
+static_fn void regex_drop(Cache_t *cp) {
+    regex_unlink(cp);
+    regfree(&cp->re);
+    free(cp);
+}
+
 /*
  * flush the cache
  */
 
 static_fn void regex_flushcache(void) {
-    int i;
+    while (matchstate.oldest) regex_drop(matchstate.oldest);
+}
 
-    for (i = matchstate.size; i--;) {
-        if (matchstate.cache[i] && matchstate.cache[i]->keep) {
-            matchstate.cache[i]->keep = 0;
-            regfree(&matchstate.cache[i]->re);
-        }
+/*
+ * (re)allocate the hash table for a cache of size re's
+ */
+
+static_fn int regex_resize(unsigned int size) {
+    unsigned int n;
+
+    regex_flushcache();
+    for (n = 16; n < size; n <<= 1) {
+        ;  // empty loop
     }
+    free(matchstate.table);
+    matchstate.table = calloc(n, sizeof(Cache_t *));
+    if (!matchstate.table) {
+        matchstate.size = matchstate.stats.size = 0;
+        return 1;
+    }
+    matchstate.mask = n - 1;
+    matchstate.size = matchstate.stats.size = size;
+    return 0;
 }
 
+/*
+ * return the cache statistics
+ */
+
+regcachestat_t *regcachestat(void) { return &matchstate.stats; }
+
 /*
  * return regcomp() compiled re for pattern and reflags
  */
 
 regex_t *regcache(const char *pattern, regflags_t reflags, int *status) {
     Cache_t *cp;
+    const char *s;
+    char *locale;
+    unsigned int hash;
     int i;
-    char *s;
-    int empty;
-    int unused;
-    int old;
-    Key_t key;
 
     /*
      * 0 pattern flushes the cache and reflags>0 extends cache
@@ -90,96 +172,74 @@ regex_t *regcache(const char *pattern, regflags_t reflags, int *status) {
     if (!pattern) {
         regex_flushcache();
         i = 0;
-        if (reflags > matchstate.size) {
-            matchstate.cache = realloc(matchstate.cache, reflags * sizeof(Cache_t *));
-            if (matchstate.cache) {
-                matchstate.size = reflags;
-            } else {
-                matchstate.size = 0;
-                i = 1;
-            }
-        }
+        if (reflags > matchstate.size) i = regex_resize(reflags);
         if (status) *status = i;
         return NULL;
     }
-    if (!matchstate.cache) {
-        matchstate.cache = calloc(1, CACHE * sizeof(Cache_t *));
-        if (!matchstate.cache) return NULL;
-        matchstate.size = CACHE;
+    if (!matchstate.table && regex_resize(CACHE)) {
+        if (status) *status = REG_ESPACE;
+        return NULL;
     }
 
     /*
-     * flush the cache if the locale changed
      * the ast setlocale() intercept maintains
      * persistent setlocale() return values
+     * so re's compiled in another locale are
+     * simply different keys
      */
 
-    if ((s = ast_setlocale(LC_CTYPE, NULL)) != matchstate.locale) {
-        matchstate.locale = s;
-        regex_flushcache();
-    }
+    locale = ast_setlocale(LC_CTYPE, NULL);
 
     /*
      * check if the pattern is in the cache
      */
 
-    for (i = 0; i < sizeof(key) && pattern[i]; i++) ((char *)&key)[i] = pattern[i];
-    for (; i < sizeof(key); i++) ((char *)&key)[i] = 0;
-    empty = unused = -1;
-    old = 0;
-    for (i = matchstate.size; i--;) {
-        if (!matchstate.cache[i]) {
-            empty = i;
-        } else if (!matchstate.cache[i]->keep) {
-            unused = i;
-        } else if (*(Key_t *)matchstate.cache[i]->pattern == key &&
-                   !strcmp(matchstate.cache[i]->pattern, pattern) &&
-                   matchstate.cache[i]->reflags == reflags) {
+    hash = (unsigned int)reflags;
+    for (s = pattern; *s; s++) hash = hash * 33 + *(unsigned char *)s;
+    for (cp = matchstate.table[hash & matchstate.mask]; cp; cp = cp->next) {
+        if (cp->hash == hash && cp->reflags == reflags && cp->locale == locale &&
+            !strcmp(cp->pattern, pattern)) {
             break;
-        } else if (!matchstate.cache[old] ||
-                   matchstate.cache[old]->serial > matchstate.cache[i]->serial) {
-            old = i;
         }
     }
-    if (i < 0) {
-        if (unused < 0) {
-            if (empty < 0) {
-                unused = old;
-            } else {
-                unused = empty;
-            }
+    if (cp) {
+        matchstate.stats.hits++;
+        if (cp != matchstate.newest) {
+            regex_detach(cp);
+            regex_touch(cp);
         }
-        if (!(cp = matchstate.cache[unused]) &&
-            !(cp = matchstate.cache[unused] = calloc(1, sizeof(Cache_t)))) {
-            if (status) *status = REG_ESPACE;
-            return NULL;
-        }
-        if (cp->keep) {
-            cp->keep = 0;
-            regfree(&cp->re);
-        }
-        if ((i = strlen(pattern) + 1) > cp->size) {
-            cp->size = roundof(i, ROUND);
-            cp->pattern = realloc(cp->pattern, cp->size);
-            if (!cp->pattern) {
-                if (status) *status = REG_ESPACE;
-                return NULL;
-            }
-        }
-        strcpy(cp->pattern, pattern);
-        while (++i < sizeof(Key_t)) cp->pattern[i] = 0;
-        pattern = (const char *)cp->pattern;
-        i = regcomp(&cp->re, pattern, reflags);
-        if (i) {
-            if (status) *status = i;
-            return NULL;
-        }
-        cp->keep = 1;
-        cp->reflags = reflags;
-    } else {
-        cp = matchstate.cache[i];
+        if (status) *status = 0;
+        return &cp->re;
+    }
+    matchstate.stats.misses++;
+
+    if (!(cp = calloc(1, sizeof(Cache_t) + (s - pattern) + 1))) {
+        if (status) *status = REG_ESPACE;
+        return NULL;
+    }
+    cp->pattern = strcpy((char *)(cp + 1), pattern);
+    i = regcomp(&cp->re, cp->pattern, reflags);
+    if (i) {
+        free(cp);
+        if (status) *status = i;
+        return NULL;
+    }
+
+    /*
+     * drop the least recently used entry if the cache is full
+     */
+
+    if (matchstate.stats.count >= matchstate.size && matchstate.oldest) {
+        regex_drop(matchstate.oldest);
+        matchstate.stats.evictions++;
     }
-    cp->serial = ++matchstate.serial;
+    cp->reflags = reflags;
+    cp->locale = locale;
+    cp->hash = hash;
+    cp->next = matchstate.table[hash & matchstate.mask];
+    matchstate.table[hash & matchstate.mask] = cp;
+    matchstate.stats.count++;
+    regex_touch(cp);
     if (status) *status = 0;
     return &cp->re;
 }
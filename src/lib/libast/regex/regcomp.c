@@ -3084,6 +3084,8 @@ again:
         if (!(p->env->stats.re_min = env.stats.m)) p->env->stats.re_min = -1;
         if (!(p->env->stats.re_max = env.stats.n)) p->env->stats.re_max = -1;
     }
+    p->env->nsub = env.stats.p + env.stats.u;
+    p->env->dfa = dfacomp(p->env);
     if (regcomp_special(&env, p)) goto bad;
     regcomp_serialize(&env, p->env->rex, 1);
     p->re_nsub = env.stats.p;
@@ -3102,7 +3104,6 @@ again:
     p->env->explicit = env.explicit;
     p->env->flags = env.flags & REG_COMP;
     p->env->min = env.stats.m;
-    p->env->nsub = env.stats.p + env.stats.u;
     p->env->refs = 1;
     return 0;
 bad:
@@ -3154,6 +3155,8 @@ int regcomb(regex_t *p, regex_t *q) {
     if (p->env->separate || q->env->separate) return REG_ESUBREG;
     memset(&env, 0, sizeof(env));
     env.disc = p->env->disc;
+    dfafree(env.disc, p->env->dfa);
+    p->env->dfa = NULL;
     if (e->type == REX_BM) {
         p->env->rex = e->next;
         e->next = NULL;
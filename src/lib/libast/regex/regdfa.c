@@ -0,0 +1,271 @@
+/***********************************************************************
+ *                                                                      *
+ *               This software is part of the ast package               *
+ *          Copyright (c) 1985-2011 AT&T Intellectual Property          *
+ *                      and is licensed under the                       *
+ *                 Eclipse Public License, Version 1.0                  *
+ *                    by AT&T Intellectual Property                     *
+ *                                                                      *
+ *                A copy of the License is available at                 *
+ *          http://www.eclipse.org/org/documents/epl-v10.html           *
+ *         (with md5 checksum b35adb5213ca9657e911e9befb180842)         *
+ *                                                                      *
+ *              Information and Software Systems Research               *
+ *                            AT&T Research                             *
+ *                           Florham Park NJ                            *
+ *                                                                      *
+ *               Glenn Fowler <glenn.s.fowler@gmail.com>                *
+ *                    David Korn <dgkorn@gmail.com>                     *
+ *                     Phong Vo <phongvo@gmail.com>                     *
+ *                                                                      *
+ ***********************************************************************/
+/*
+ * lazy dfa for the backtracking free subset of regular expressions
+ *
+ * a chain of single byte dot, class, onechar and string nodes with
+ * optional leading ^ and trailing $ is flattened into at most DFA_POS
+ * positions, each matching a set of bytes and optionally skippable
+ * and/or repeatable.  the nfa state is a bit set of positions and
+ * deterministic states are built on demand from it, so a match is
+ * decided in one pass over the subject regardless of the pattern
+ */
+#include "config_ast.h"  // IWYU pragma: keep
+
+#include <limits.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "reglib.h"
+
+#define DFA_POS 63       /* max positions, bit 63 is final      */
+#define DFA_STATES 128   /* max cached dfa states               */
+#define DFA_NEXT 8192    /* max transition table entries        */
+
+typedef uint64_t Dfaset_t;
+
+struct Dfa_s {
+    Dfaset_t skip;                      /* positions that match empty */
+    Dfaset_t loop;                      /* positions that repeat      */
+    Dfaset_t final;                     /* all positions matched      */
+    Dfaset_t start;                     /* initial state              */
+    unsigned char bol;                  /* anchored at beginning      */
+    unsigned char eol;                  /* anchored at end            */
+    int nclass;                         /* # byte equivalence classes */
+    int nstate;                         /* # dfa states so far        */
+    int maxstate;                       /* max # dfa states           */
+    unsigned char class[UCHAR_MAX + 1]; /* byte -> class              */
+    Dfaset_t *mask;                     /* class -> positions         */
+    Dfaset_t *set;                      /* state -> nfa positions     */
+    short *next;                        /* state x class -> state     */
+};
+
+/*
+ * add the positions reachable by skipping optional positions
+ */
+
+static_fn Dfaset_t dfa_closure(Dfa_t *dfa, Dfaset_t d) {
+    Dfaset_t e;
+
+    while ((e = d | ((d & dfa->skip) << 1)) != d) d = e;
+    return d;
+}
+
+/*
+ * nfa transition from positions d on byte class c
+ */
+
+static_fn Dfaset_t dfa_step(Dfa_t *dfa, Dfaset_t d, int c) {
+    d &= dfa->mask[c];
+    d = dfa_closure(dfa, (d << 1) | (d & dfa->loop));
+    if (!dfa->bol) d |= dfa->start;
+    return d;
+}
+
+/*
+ * return the dfa state for positions d, -1 if the state table is full
+ */
+
+static_fn int dfa_state(Dfa_t *dfa, Dfaset_t d) {
+    int i;
+
+    for (i = 0; i < dfa->nstate; i++) {
+        if (dfa->set[i] == d) return i;
+    }
+    if (i >= dfa->maxstate) return -1;
+    dfa->set[i] = d;
+    memset(dfa->next + i * dfa->nclass, 0xff, dfa->nclass * sizeof(short));
+    dfa->nstate++;
+    return i;
+}
+
+/*
+ * compile the env->rex chain to a dfa if it qualifies
+ * 0 returned if it doesn't, the caller falls back to the backtracking matcher
+ */
+
+Dfa_t *dfacomp(Env_t *env) {
+    Rex_t *e;
+    Dfa_t *dfa;
+    Set_t set[DFA_POS];
+    Dfaset_t mask[UCHAR_MAX + 1];
+    unsigned char class[UCHAR_MAX + 1];
+    Dfaset_t skip = 0;
+    Dfaset_t loop = 0;
+    Dfaset_t m;
+    unsigned char *s;
+    int bol = 0;
+    int eol = 0;
+    int vary = 0;
+    int n = 0;
+    int c;
+    int i;
+    int k;
+    int w;
+    int nclass;
+    int maxstate;
+
+    if (mbwide() || env->hard || env->nsub || env->leading >= 0) return NULL;
+    for (e = env->rex; e; e = e->next) {
+        switch (e->type) {
+            case REX_BEG:
+                if (e != env->rex || (e->flags & REG_NEWLINE)) return NULL;
+                bol = 1;
+                continue;
+            case REX_END:
+                if (e->next || (e->flags & REG_NEWLINE)) return NULL;
+                eol = 1;
+                continue;
+            case REX_STRING:
+                if (n + (int)e->re.string.size > DFA_POS) return NULL;
+                for (s = e->re.string.base, i = 0; i < e->re.string.size; i++, n++) {
+                    memset(&set[n], 0, sizeof(set[n]));
+                    for (c = 0; c <= UCHAR_MAX; c++) {
+                        if ((e->map ? e->map[c] : c) == s[i]) setadd(&set[n], c);
+                    }
+                }
+                continue;
+            case REX_DOT:
+            case REX_CLASS:
+            case REX_ONECHAR:
+                break;
+            default:
+                return NULL;
+        }
+        if (e->explicit >= 0 && e->type != REX_DOT) return NULL;
+        if (e->hi == RE_DUP_INF) {
+            w = e->lo ? e->lo : 1;
+        } else {
+            w = e->hi;
+        }
+        if (w <= 0 || w > DFA_POS - n) return NULL;
+        if (e->lo != e->hi) vary = 1;
+        for (k = 0; k < w; k++, n++) {
+            memset(&set[n], 0, sizeof(set[n]));
+            for (c = 0; c <= UCHAR_MAX; c++) {
+                switch (e->type) {
+                    case REX_DOT:
+                        if (c != e->explicit) setadd(&set[n], c);
+                        break;
+                    case REX_CLASS:
+                        if (settst(e->re.charclass, c)) setadd(&set[n], c);
+                        break;
+                    default:
+                        if ((e->map ? e->map[c] : c) == e->re.onechar) setadd(&set[n], c);
+                        break;
+                }
+            }
+            if (k >= e->lo) skip |= (Dfaset_t)1 << n;
+        }
+        if (e->hi == RE_DUP_INF) loop |= (Dfaset_t)1 << (n - 1);
+    }
+
+    /*
+     * fixed length patterns don't backtrack, leave them to the bm/kmp matchers
+     */
+
+    if (!vary || !n) return NULL;
+
+    /*
+     * partition the bytes into classes with identical position masks
+     */
+
+    nclass = 0;
+    for (c = 0; c <= UCHAR_MAX; c++) {
+        for (m = 0, k = 0; k < n; k++) {
+            if (settst(&set[k], c)) m |= (Dfaset_t)1 << k;
+        }
+        for (k = 0; k < nclass; k++) {
+            if (mask[k] == m) break;
+        }
+        if (k >= nclass) mask[nclass++] = m;
+        class[c] = k;
+    }
+    maxstate = DFA_NEXT / nclass;
+    if (maxstate > DFA_STATES) maxstate = DFA_STATES;
+    dfa = regalloc(env->disc, 0,
+                   sizeof(Dfa_t) + (nclass + maxstate) * sizeof(Dfaset_t) +
+                       maxstate * nclass * sizeof(short));
+    if (!dfa) return NULL;
+    memset(dfa, 0, sizeof(Dfa_t));
+    dfa->mask = (Dfaset_t *)(dfa + 1);
+    dfa->set = dfa->mask + nclass;
+    dfa->next = (short *)(dfa->set + maxstate);
+    memcpy(dfa->mask, mask, nclass * sizeof(Dfaset_t));
+    memcpy(dfa->class, class, sizeof(dfa->class));
+    dfa->nclass = nclass;
+    dfa->skip = skip;
+    dfa->loop = loop;
+    dfa->final = (Dfaset_t)1 << n;
+    dfa->bol = bol;
+    dfa->eol = eol;
+    dfa->maxstate = maxstate;
+    dfa->start = dfa_closure(dfa, 1);
+    dfa_state(dfa, dfa->start);
+    return dfa;
+}
+
+/*
+ * run the dfa on s of size len
+ * 1 returned on match, 0 otherwise
+ * if whole!=0 the match must span all of s, -1 returned if the
+ * pattern isn't anchored at both ends
+ */
+
+int dfaexec(Dfa_t *dfa, const unsigned char *s, size_t len, int whole) {
+    const unsigned char *e = s + len;
+    Dfaset_t d;
+    int i = 0;
+    int j;
+    int c;
+
+    if (whole && !(dfa->bol && dfa->eol)) return -1;
+    d = dfa->start;
+    if (!dfa->eol && (d & dfa->final)) return 1;
+    while (s < e) {
+        c = dfa->class[*s++];
+        if ((j = dfa->next[i * dfa->nclass + c]) < 0) {
+            d = dfa_step(dfa, dfa->set[i], c);
+            if ((j = dfa_state(dfa, d)) < 0) {
+                /*
+                 * state table full -- continue on the nfa bit sets
+                 */
+
+                for (;;) {
+                    if (!d) return 0;
+                    if (!dfa->eol && (d & dfa->final)) return 1;
+                    if (s >= e) return (d & dfa->final) != 0;
+                    d = dfa_step(dfa, d, dfa->class[*s++]);
+                }
+            }
+            dfa->next[i * dfa->nclass + c] = j;
+        }
+        d = dfa->set[i = j];
+        if (!d) return 0;
+        if (!dfa->eol && (d & dfa->final)) return 1;
+    }
+    return (d & dfa->final) != 0;
+}
+
+void dfafree(regdisc_t *disc, Dfa_t *dfa) {
+    if (dfa) (void)regalloc(disc, dfa, 0);
+}
@@ -42,6 +42,9 @@
 
 #define alloc _reg_alloc
 #define classfun _reg_classfun
+#define dfacomp _reg_dfacomp
+#define dfaexec _reg_dfaexec
+#define dfafree _reg_dfafree
 #define drop _reg_drop
 #define fatal _reg_fatal
 #define state _reg_state
@@ -414,9 +417,12 @@ typedef struct Rex_s {
     } re;
 } Rex_t;
 
+typedef struct Dfa_s Dfa_t;
+
 typedef struct reglib_s /* library private regex_t info */
 {
     struct Rex_s *rex;                 /* compiled expression           */
+    Dfa_t *dfa;                        /* lazy dfa for simple rex       */
     regdisc_t *disc;                   /* REG_DISCIPLINE discipline     */
     const regex_t *regex;              /* from regexec                  */
     unsigned char *beg;                /* beginning of string           */
@@ -474,6 +480,9 @@ extern State_t state;
 
 extern void *alloc(regdisc_t *, void *, size_t);
 extern regclass_t classfun(int);
+extern Dfa_t *dfacomp(Env_t *);
+extern int dfaexec(Dfa_t *, const unsigned char *, size_t, int);
+extern void dfafree(regdisc_t *, Dfa_t *);
 extern void drop(regdisc_t *, Rex_t *);
 extern int fatal(regdisc_t *, int, const char *);
 
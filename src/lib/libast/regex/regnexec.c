@@ -1728,6 +1728,22 @@ int regnexec(const regex_t *p, const char *s, size_t len, size_t nmatch, regmatc
                    sfprintf(sfstdout, "AHA#%04d REG_NOMATCH %d %d\n", __LINE__, len, env->min));
         return REG_NOMATCH;
     }
+    if (env->dfa && !(flags & (REG_ADVANCE | REG_INVERT | REG_LEFT | REG_NOTBOL | REG_NOTEOL))) {
+        j = !(env->flags & REG_NOSUB) && nmatch;
+        k = dfaexec(env->dfa, (unsigned char *)s, len, j);
+        if (!k) return REG_NOMATCH;
+        if (k > 0) {
+            if (j) {
+                match[0].rm_so = 0;
+                match[0].rm_eo = len;
+                for (i = 1; i < nmatch; i++) match[i] = state.nomatch;
+                if ((env->flags & (REG_SHELL | REG_AUGMENTED)) == (REG_SHELL | REG_AUGMENTED)) {
+                    ((regex_t *)p)->re_nsub = 0;
+                }
+            }
+            return 0;
+        }
+    }
     env->regex = p;
     env->beg = (unsigned char *)s;
     env->end = env->beg + len;
@@ -1874,6 +1890,7 @@ void regfree(regex_t *p) {
         p->env = 0;
         if (--env->refs <= 0 && !(env->disc->re_flags & REG_NOFREE)) {
             drop(env->disc, env->rex);
+            dfafree(env->disc, env->dfa);
             if (env->pos) vecclose(env->pos);
             if (env->bestpos) vecclose(env->bestpos);
             if (env->mst) stkclose(env->mst);
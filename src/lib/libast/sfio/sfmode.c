@@ -130,7 +130,7 @@ int _sfsetpool(Sfio_t *f) {
             p->sf = p->array;
         } else /* allocate a larger array */
         {
-            n = (p->sf != p->array ? p->s_sf : (p->s_sf / 4 + 1) * 4) + 4;
+            n = (p->sf != p->array ? p->s_sf : (p->s_sf / 4 + 1) * 4) * 2;
             if (!(array = malloc(n * sizeof(Sfio_t *)))) goto done;
 
             /* move old array to new one */
@@ -35,6 +35,25 @@
 **      Written by Kiem-Phong Vo.
 */
 
+/*
+ * return the index of f in its pool, -1 if it isn't in one
+ * the pool is searched from both ends since stacks of streams, such as the
+ * stk streams of function definitions, are usually swapped with a stream
+ * that was opened long before them and so is near the front
+ */
+static_fn int poolindex(Sfio_t *f) {
+    Sfio_t **sf;
+    int i, n;
+
+    if (!f->pool) return -1;
+    sf = f->pool->sf;
+    for (i = 0, n = f->pool->n_sf - 1; i <= n; i++, n--) {
+        if (sf[n] == f) return n;
+        if (sf[i] == f) return i;
+    }
+    return -1;
+}
+
 Sfio_t *sfswap(Sfio_t *f1, Sfio_t *f2) {
     Sfio_t tmp;
     int f1pool, f2pool, f1mode, f2mode, f1flags, f2flags;
@@ -67,20 +86,8 @@ Sfio_t *sfswap(Sfio_t *f1, Sfio_t *f2) {
         f2mode = SF_AVAIL;
     }
 
-    if (!f1->pool) {
-        f1pool = -1;
-    } else {
-        for (f1pool = f1->pool->n_sf - 1; f1pool >= 0; --f1pool) {
-            if (f1->pool->sf[f1pool] == f1) break;
-        }
-    }
-    if (!f2->pool) {
-        f2pool = -1;
-    } else {
-        for (f2pool = f2->pool->n_sf - 1; f2pool >= 0; --f2pool) {
-            if (f2->pool->sf[f2pool] == f2) break;
-        }
-    }
+    f1pool = poolindex(f1);
+    f2pool = poolindex(f2);
 
     f1flags = f1->flags;
     f2flags = f2->flags;
@@ -0,0 +1,73 @@
+#include "config_ast.h"  // IWYU pragma: keep
+
+#include <stddef.h>
+#include <string.h>
+
+#include "ast.h"
+#include "option.h"
+#include "terror.h"
+
+// The same options with and without the [-c] flag that enables the per usage option cache.
+#define OPTIONS                                                                   \
+    "[a|b!:bee?Alias and inverted.][m|C:chars?Alias.][N!:utf8?Inverted.]"         \
+    "[n:lines]#[lines?Numeric.][s:sep]:[sep?String.][o:opt]#?[num?Optional.]" \
+    "[x:ex?Plain.]"
+
+static const char plain[] = "[-1?\n@(#)$Id: plain (AT&T Research) 2020-01-01 $\n]" OPTIONS;
+static const char cached[] = "[-1c?\n@(#)$Id: cached (AT&T Research) 2020-01-01 $\n]" OPTIONS;
+
+static char *args[] = {"cmd", "-b", "-a", "-C", "-m", "-N", "-n", "5", "-n7", "-s:", "-sx",
+                       "-o", "-x", "-o3", "-xN", "--", "arg", NULL};
+
+#define MAXOPT 32
+
+typedef struct Result_s {
+    int c;
+    long num;
+    char arg[8];
+} Result_t;
+
+static int parse(const char *usage, Result_t *rp) {
+    int n = 0;
+    int c;
+
+    opt_info.index = 0;
+    while ((c = optget(args, usage)) && n < MAXOPT) {
+        rp[n].c = c;
+        rp[n].num = opt_info.num;
+        strlcpy(rp[n].arg, opt_info.arg ? opt_info.arg : "(null)", sizeof(rp[n].arg));
+        n++;
+    }
+    return n;
+}
+
+tmain() {
+    UNUSED(argc);
+    UNUSED(argv);
+    Result_t expect[MAXOPT];
+    Result_t actual[MAXOPT];
+    int n;
+
+    n = parse(plain, expect);
+    if (n != 14) terror("expected 14 options got %d", n);
+    if (expect[0].c != 'a' || expect[0].num || expect[3].c != 'm' || expect[4].num) {
+        terror("aliases or inverted options parsed wrong");
+    }
+
+    // The first call builds the cache, the later calls consult it.
+    for (int pass = 1; pass <= 3; pass++) {
+        if (parse(cached, actual) != n) terror("pass %d parsed a different number of options", pass);
+        for (int i = 0; i < n; i++) {
+            if (actual[i].c != expect[i].c || actual[i].num != expect[i].num ||
+                strcmp(actual[i].arg, expect[i].arg)) {
+                terror("pass %d option %d expected %c,%ld,%s got %c,%ld,%s", pass, i, expect[i].c,
+                       expect[i].num, expect[i].arg, actual[i].c, actual[i].num, actual[i].arg);
+            }
+        }
+        if (!args[opt_info.index] || strcmp(args[opt_info.index], "arg")) {
+            terror("pass %d stopped at the wrong argument", pass);
+        }
+    }
+
+    texit(0);
+}
@@ -0,0 +1,63 @@
+#include "config_ast.h"  // IWYU pragma: keep
+
+#include <stddef.h>
+
+#include "ast.h"
+#include "ast_regex.h"
+#include "terror.h"
+
+static const char *patterns[] = {"a*b", "c?d", "[ef]g", "h@(i|j)", "k+(l)"};
+
+tmain() {
+    UNUSED(argc);
+    UNUSED(argv);
+    regcachestat_t *sp = regcachestat();
+    regex_t *re, *rp;
+    unsigned long hits, misses;
+    int status;
+
+    re = regcache(patterns[0], REG_SHELL | REG_AUGMENTED, &status);
+    if (!re || status) terror("regcache() failed to compile '%s'", patterns[0]);
+    if (regexec(re, "aaab", 0, NULL, 0)) terror("'%s' does not match 'aaab'", patterns[0]);
+    hits = sp->hits;
+    rp = regcache(patterns[0], REG_SHELL | REG_AUGMENTED, &status);
+    if (rp != re || sp->hits != hits + 1) terror("regcache() did not find '%s'", patterns[0]);
+    misses = sp->misses;
+    rp = regcache(patterns[0], REG_SHELL | REG_AUGMENTED | REG_ICASE, &status);
+    if (!rp || rp == re || sp->misses != misses + 1) {
+        terror("regcache() did not key '%s' on the flags", patterns[0]);
+    }
+
+    // Fill the cache so the lru order can be observed.
+    regcache(NULL, 0, &status);
+    if (status || sp->count) terror("regcache() flush failed");
+    if (sp->size < 4) terror("regcache() has only %u entries", sp->size);
+    for (int i = 0; i < 4; i++) regcache(patterns[i], REG_SHELL | REG_AUGMENTED, &status);
+    regcache(patterns[0], REG_SHELL | REG_AUGMENTED, &status);
+    for (unsigned int i = 4; i < sp->size; i++) {
+        char pattern[16];
+        sfsprintf(pattern, sizeof(pattern), "x%u", i);
+        regcache(pattern, REG_SHELL | REG_AUGMENTED, &status);
+    }
+    if (sp->count != sp->size || sp->evictions) {
+        terror("regcache() should hold %u entries, holds %u", sp->size, sp->count);
+    }
+    regcache(patterns[4], REG_SHELL | REG_AUGMENTED, &status);
+    if (sp->count != sp->size || sp->evictions != 1) {
+        terror("regcache() should have evicted one entry, evicted %lu", sp->evictions);
+    }
+    hits = sp->hits;
+    regcache(patterns[0], REG_SHELL | REG_AUGMENTED, &status);
+    if (sp->hits != hits + 1) terror("regcache() evicted recently used '%s'", patterns[0]);
+    misses = sp->misses;
+    regcache(patterns[1], REG_SHELL | REG_AUGMENTED, &status);
+    if (sp->misses != misses + 1) {
+        terror("regcache() did not evict least recently used '%s'", patterns[1]);
+    }
+
+    misses = sp->count;
+    if (regcache("a[", 0, &status) || !status) terror("regcache() compiled invalid pattern 'a['");
+    if (sp->count != misses) terror("regcache() kept invalid pattern 'a['");
+
+    texit(0);
+}
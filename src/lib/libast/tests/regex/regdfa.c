@@ -0,0 +1,91 @@
+#include "config_ast.h"  // IWYU pragma: keep
+
+#include <stddef.h>
+#include <string.h>
+
+#include "ast.h"
+#include "ast_regex.h"
+#include "terror.h"
+
+#define SHELL (REG_SHELL | REG_AUGMENTED)
+#define WHOLE (REG_SHELL | REG_AUGMENTED | REG_LEFT | REG_RIGHT)
+
+static const struct {
+    const char *pattern;
+    regflags_t flags;
+    const char *subject;
+    int match;
+} tests[] = {
+    {"a*b", WHOLE, "aaab", 1},
+    {"a*b", WHOLE, "aaabc", 0},
+    {"a*b", SHELL, "xaaabc", 1},
+    {"*a*b", WHOLE, "xxaxxb", 1},
+    {"*a*b", WHOLE, "xxbxxa", 0},
+    {"a?c", WHOLE, "abc", 1},
+    {"a?c", WHOLE, "ac", 0},
+    {"*[bc]", WHOLE, "abc", 1},
+    {"*[!bc]", WHOLE, "abc", 0},
+    {"~(i)a*c", WHOLE, "ABC", 1},
+    {"*", WHOLE, "", 1},
+    {"*x*", WHOLE, "", 0},
+    {"^ab*c$", REG_EXTENDED, "abbbc", 1},
+    {"^ab*c$", REG_EXTENDED, "abbbcd", 0},
+    {"ab*c", REG_EXTENDED, "xxacxx", 1},
+    {"ab+c", REG_EXTENDED, "xxacxx", 0},
+    {"ab{2,3}c", REG_EXTENDED, "abbc", 1},
+    {"ab{2,3}c", REG_EXTENDED, "abbbbc", 0},
+    {"^a.*b.*c$", REG_EXTENDED, "a--b--c", 1},
+    {"^a.*b.*c$", REG_EXTENDED, "a--c--b", 0},
+    {"a.c", REG_EXTENDED | REG_NEWLINE, "a\nc", 0},
+};
+
+tmain() {
+    UNUSED(argc);
+    UNUSED(argv);
+    regex_t re;
+    regmatch_t match[4];
+    char subject[4097];
+
+    for (int i = 0; i < elementsof(tests); i++) {
+        if (regcomp(&re, tests[i].pattern, tests[i].flags)) {
+            terror("regcomp('%s') failed", tests[i].pattern);
+            continue;
+        }
+        int n = !regexec(&re, tests[i].subject, 0, NULL, 0);
+        if (n != tests[i].match) {
+            terror("'%s' match '%s' expected %d got %d", tests[i].pattern, tests[i].subject,
+                   tests[i].match, n);
+        }
+        n = !regexec(&re, tests[i].subject, elementsof(match), match, 0);
+        if (n != tests[i].match) {
+            terror("'%s' match '%s' with subexpressions expected %d got %d", tests[i].pattern,
+                   tests[i].subject, tests[i].match, n);
+        }
+        if (n && (tests[i].flags & WHOLE) == WHOLE &&
+            (match[0].rm_so != 0 || match[0].rm_eo != strlen(tests[i].subject) ||
+             match[1].rm_so != -1)) {
+            terror("'%s' match '%s' expected 0,%d got %d,%d", tests[i].pattern, tests[i].subject,
+                   (int)strlen(tests[i].subject), (int)match[0].rm_so, (int)match[0].rm_eo);
+        }
+        if (n && tests[i].pattern[0] == '^' &&
+            !regexec(&re, tests[i].subject, 0, NULL, REG_NOTBOL)) {
+            terror("'%s' matched '%s' with REG_NOTBOL", tests[i].pattern, tests[i].subject);
+        }
+        regfree(&re);
+    }
+
+    // Patterns that backtrack exponentially must still be decided quickly.
+    memset(subject, 'a', sizeof(subject) - 1);
+    subject[sizeof(subject) - 1] = 0;
+    if (regcomp(&re, "*a*a*a*a*a*a*a*b", WHOLE)) terror("regcomp() failed");
+    if (!regexec(&re, subject, 0, NULL, 0)) terror("'*a*a*a*a*a*a*a*b' matched all a's");
+    if (!regexec(&re, subject, elementsof(match), match, 0)) {
+        terror("'*a*a*a*a*a*a*a*b' matched all a's with subexpressions");
+    }
+    regfree(&re);
+    if (regcomp(&re, "a*a*a*a*a*a*a*b", REG_EXTENDED)) terror("regcomp() failed");
+    if (!regexec(&re, subject, 0, NULL, 0)) terror("'a*a*a*a*a*a*a*b' matched all a's");
+    regfree(&re);
+
+    texit(0);
+}
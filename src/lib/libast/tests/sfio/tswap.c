@@ -47,5 +47,27 @@ tmain() {
 
     if (sfswap(f1, f2)) terror("sfswap should have failed");
 
+    // Swap streams at both ends of a large pool, like the stk stacks of many functions.
+    Sfio_t *pool[1000];
+    char buf[16];
+    for (int i = 0; i < elementsof(pool); i++) {
+        pool[i] = sfnew(NULL, NULL, -1, -1, SF_STRING | SF_WRITE);
+        if (!pool[i]) terror("Can't open string");
+        sfprintf(pool[i], "%d", i);
+    }
+    for (int i = 0; i < elementsof(pool); i++) {
+        f1 = pool[i % 3];
+        f2 = pool[elementsof(pool) - 1 - i];
+        if (f1 == f2) continue;
+        if (sfswap(f1, f2) != f2 || sfswap(f2, f1) != f1) terror("Can't swap pool streams");
+    }
+    for (int i = 0; i < elementsof(pool); i++) {
+        sfsprintf(buf, sizeof(buf), "%d", i);
+        sfputc(pool[i], 0);
+        if (strcmp(sfstrbase(pool[i]), buf)) terror("Pool stream %d has wrong data", i);
+    }
+    if (sfsync(NULL) < 0) terror("sfsync(NULL) failed");
+    for (int i = 0; i < elementsof(pool); i++) sfclose(pool[i]);
+
     texit(0);
 }
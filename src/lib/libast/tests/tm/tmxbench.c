@@ -0,0 +1,48 @@
+#include "config_ast.h"  // IWYU pragma: keep
+
+#include <stdlib.h>
+#include <time.h>
+
+#include "ast.h"
+#include "sfio.h"
+#include "tm.h"
+#include "tmx.h"
+
+// Time formatting and parsing throughput, run by `meson test --benchmark`. The timestamps advance
+// a few seconds at a time like the records of a log file. An optional argument sets the count.
+
+static double elapsed(struct timespec *start) {
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - start->tv_sec) + (now.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+int main(int argc, char **argv) {
+    long count = argc > 1 ? strtol(argv[1], NULL, 10) : 1000000;
+    struct timespec start;
+    Time_t t;
+    Time_t sum = 0;
+    char *e;
+    char buf[64];
+    char arg[32];
+    double secs;
+
+    sh_setenviron("TZ=EST5EDT,M3.2.0,M11.1.0");
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    t = tmxsns(1700000000, 0);
+    for (long i = 0; i < count; i++, t += tmxsns(3, 0)) {
+        tmxfmt(buf, sizeof(buf), "%Y-%m-%d %H:%M:%S", t);
+    }
+    secs = elapsed(&start);
+    sfprintf(sfstdout, "tmxfmt  %ld times %.3fs %.0f/s\n", count, secs, count / secs);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (long i = 0; i < count; i++) {
+        sfsprintf(arg, sizeof(arg), "#%ld", 1700000000 + 3 * i);
+        sum += tmxdate(arg, &e, TMX_NOW);
+    }
+    secs = elapsed(&start);
+    sfprintf(sfstdout, "tmxdate %ld times %.3fs %.0f/s\n", count, secs, count / secs);
+    return sum == 0;
+}
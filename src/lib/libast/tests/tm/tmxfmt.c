@@ -0,0 +1,61 @@
+#include "config_ast.h"  // IWYU pragma: keep
+
+#include <string.h>
+#include <time.h>
+
+#include "ast.h"
+#include "terror.h"
+#include "tm.h"
+#include "tmx.h"
+
+// Zones with and without daylight saving time. The times stepped through below cross the 2024 US
+// and EU transitions in both directions.
+static const char *zones[] = {"TZ=UTC", "TZ=EST5EDT,M3.2.0,M11.1.0",
+                              "TZ=CET-1CEST,M3.5.0,M10.5.0/3"};
+
+static const struct {
+    time_t start;
+    int step;
+    int count;
+} runs[] = {
+    {1710050000, 37, 1000},    // 2024-03-10 US spring forward
+    {1711846000, 13, 1000},    // 2024-03-31 EU spring forward
+    {1730613000, 59, 1000},    // 2024-11-03 US fall back
+    {1730682000, -61, 1000},   // backwards over the same transition
+    {1700000000, 1, 200},      // every second of a few minutes
+    {1700000000, 86399, 400},  // nearly a day apart
+};
+
+tmain() {
+    UNUSED(argc);
+    UNUSED(argv);
+    char expect[64];
+    char actual[64];
+
+    for (int z = 0; z < elementsof(zones); z++) {
+        sh_setenviron(zones[z]);
+        tzset();
+        for (int r = 0; r < elementsof(runs); r++) {
+            time_t t = runs[r].start;
+            for (int i = 0; i < runs[r].count; i++, t += runs[r].step) {
+                strftime(expect, sizeof(expect), "%Y-%m-%d %H:%M:%S %a %j", localtime(&t));
+                tmxfmt(actual, sizeof(actual), "%Y-%m-%d %H:%M:%S %a %j", tmxsns(t, 0));
+                if (strcmp(actual, expect)) {
+                    terror("%s %ld expected '%s' got '%s'", zones[z], (long)t, expect, actual);
+                    break;
+                }
+            }
+        }
+    }
+
+    // Padding and widths are formatted without sfsprintf().
+    sh_setenviron("TZ=UTC");
+    tmxfmt(actual, sizeof(actual), "%e|%-d|%_H|%3N|%N|%_5m|%-j|%10Y", tmxsns(1700000000, 12345678));
+    if (strcmp(actual, "14|14|22|012|012345678|   11|318|2023000000")) {
+        terror("padded fields wrong '%s'", actual);
+    }
+    tmxfmt(actual, 8, "%Y-%m-%d", tmxsns(1700000000, 0));
+    if (strcmp(actual, "2023-11")) terror("truncated format wrong '%s'", actual);
+
+    texit(0);
+}
@@ -339,6 +339,12 @@ void tminit(Tm_zone_t *zp) {
         if (tm_info.local) {
             memset(tm_info.local, 0, sizeof(*tm_info.local));
             tm_info.local = 0;
+
+            /*
+             * tmlocal() sets TM_UTC for a UTC zone, it must not stick to the next TZ
+             */
+
+            tm_info.flags &= ~TM_UTC;
         }
     }
     if (!tm_info.local) tmlocal();
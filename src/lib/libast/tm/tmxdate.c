@@ -34,6 +34,7 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "ast.h"
 #include "tm.h"
 #include "tmx.h"
 
@@ -176,6 +177,9 @@ Time_t tmxdate(const char *s, char **e, Time_t now) {
     Tm_t ts;
     char skip[UCHAR_MAX + 1];
 
+    static uint32_t serial = ~(uint32_t)0;
+    static char separator[UCHAR_MAX + 1];
+
     /*
      * check DATEMSK first
      */
@@ -201,8 +205,13 @@ reset:
     set = state = 0;
     type = 0;
     zone = TM_LOCALZONE;
-    skip[0] = 0;
-    for (n = 1; n <= UCHAR_MAX; n++) skip[n] = isspace(n) || strchr("_,;@=|!^()[]{}", n);
+    if (serial != ast.locale.serial) {
+        serial = ast.locale.serial;
+        for (n = 1; n <= UCHAR_MAX; n++) {
+            separator[n] = isspace(n) || strchr("_,;@=|!^()[]{}", n);
+        }
+    }
+    memcpy(skip, separator, sizeof(skip));
 
     /*
      * get <weekday year month day hour minutes seconds ?[ds]t [ap]m>
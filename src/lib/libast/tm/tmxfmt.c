@@ -50,6 +50,11 @@
 
 static_fn char *tmx_number(char *s, char *e, long n, int p, int w, int pad) {
     char *b;
+    char *d;
+    unsigned long u;
+    int z;
+    int fill;
+    char digits[3 * sizeof(u)];
 
     if (w) {
         if (p > 0 && (pad == 0 || pad == '0')) {
@@ -72,14 +77,35 @@ static_fn char *tmx_number(char *s, char *e, long n, int p, int w, int pad) {
             if (p < 0) p = -p;
             break;
     }
-    b = s;
-    if (p > 0) {
-        s += sfsprintf(s, e - s, "%0*lu", p, n);
-    } else if (p < 0) {
-        s += sfsprintf(s, e - s, "%*lu", -p, n);
+
+    /*
+     * this is called for every field of every time formatted
+     * so the digits are converted here rather than by sfsprintf()
+     */
+
+    d = &digits[sizeof(digits)];
+    u = n;
+    do {
+        *--d = '0' + u % 10;
+    } while (u /= 10);
+    z = &digits[sizeof(digits)] - d;
+    if (p < 0) {
+        p = -p;
+        fill = ' ';
     } else {
-        s += sfsprintf(s, e - s, "%lu", n);
+        fill = '0';
+    }
+    b = s;
+    for (; p > z; p--) {
+        if (s < e - 1) *s = fill;
+        s++;
+    }
+    while (z--) {
+        if (s < e - 1) *s = *d;
+        s++;
+        d++;
     }
+    if (b < e) *(s < e ? s : e - 1) = 0;
     if (w && (s - b) > w) *(s = b + w) = 0;
     return s;
 }
@@ -30,6 +30,7 @@
 #include <stdint.h>
 #include <time.h>
 
+#include "ast.h"
 #include "tm.h"
 #include "tmx.h"
 
@@ -39,11 +40,20 @@
  */
 
 Tm_t *tmxtm(Tm_t *tm, Time_t t, Tm_zone_t *zone) {
+    static struct {
+        Tmxsec_t minute;
+        uint32_t serial;
+        int flags;
+        Tm_zone_t *zone;
+        Tm_zone_t *info;
+        Tm_t tm;
+    } last;
     struct tm *tp;
     Tm_leap_t *lp;
     Time_t x;
     time_t now;
     int leapsec;
+    int cache;
     int y;
     uint32_t n;
     int32_t o;
@@ -53,6 +63,23 @@ Tm_t *tmxtm(Tm_t *tm, Time_t t, Tm_zone_t *zone) {
 #endif
 
     tminit(tm_info.zone);
+
+    /*
+     * zone offsets are whole minutes so times in the same minute
+     * differ only in seconds -- a run of nearby timestamps pays
+     * for the full conversion once a minute
+     */
+
+    x = tmxsec(t);
+    cache = (tm_info.flags & (TM_ADJUST | TM_LEAP)) != (TM_ADJUST | TM_LEAP) &&
+            x > 2 * 24 * 60 * 60;
+    if (cache && x / 60 == last.minute && last.serial == ast.env_serial &&
+        last.flags == tm_info.flags && last.zone == zone && last.info == tm_info.zone) {
+        *tm = last.tm;
+        tm->tm_sec = x % 60;
+        tm->tm_nsec = tmxnsec(t);
+        return tm;
+    }
     leapsec = 0;
     if ((tm_info.flags & (TM_ADJUST | TM_LEAP)) == (TM_ADJUST | TM_LEAP) && (n = tmxsec(t))) {
         for (lp = &tm_data.leap[0]; n < lp->time; lp++) {
@@ -118,6 +145,14 @@ Tm_t *tmxtm(Tm_t *tm, Time_t t, Tm_zone_t *zone) {
             tmfix(tm);
         }
     }
+    if (cache) {
+        last.minute = tmxsec(t) / 60;
+        last.serial = ast.env_serial;
+        last.flags = tm_info.flags;
+        last.zone = zone;
+        last.info = tm_info.zone;
+        last.tm = *tm;
+    }
     return tm;
 }
 
@@ -36,7 +36,7 @@
 #include "shcmd.h"
 
 static const char usage[] =
-    "[-?\n@(#)$Id: basename (AT&T Research) 2010-05-06 $\n]" USAGE_LICENSE
+    "[-c?\n@(#)$Id: basename (AT&T Research) 2010-05-06 $\n]" USAGE_LICENSE
     "[+NAME?basename - strip directory and suffix from filenames]"
     "[+DESCRIPTION?\bbasename\b removes all leading directory components "
     "from the file name defined by \astring\a. If the file name defined by "
@@ -31,6 +31,11 @@
 #include <limits.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#if _lib_sendfile
+#include <sys/sendfile.h>
+#endif
 
 #include "ast.h"
 #include "error.h"
@@ -39,7 +44,7 @@
 #include "shcmd.h"
 
 static const char usage[] =
-    "[-?\n@(#)$Id: cat (AT&T Research) 2013-09-13 $\n]" USAGE_LICENSE
+    "[-c?\n@(#)$Id: cat (AT&T Research) 2013-09-13 $\n]" USAGE_LICENSE
     "[+NAME?cat - concatenate files]"
     "[+DESCRIPTION?\bcat\b copies each \afile\a in sequence to the standard"
     "   output. If no \afile\a is given, or if the \afile\a is \b-\b,"
@@ -341,6 +346,63 @@ static int vcat(char *states, Sfio_t *ip, Sfio_t *op, int flags) {
     }
 }
 
+/*
+ * copy the rest of the regular file ip to op in the kernel
+ * the copy stops at the size ip had on entry, sfmove() picks up anything appended since
+ * the sfio positions of ip and op are updated to reflect what was copied
+ * whatever is left (nothing if all went well) is up to the caller to sfmove()
+ */
+
+static void fastcat(Sfio_t *ip, Sfio_t *op) {
+#if _lib_copy_file_range || _lib_sendfile
+    Sfdisc_t *dp;
+    Sfio_t *hp;
+    Sfoff_t beg;
+    off_t off;
+    off_t n;
+    ssize_t r;
+    int in = sffileno(ip);
+    int out = sffileno(op);
+    int how = 0;
+    struct stat st;
+
+    if (in < 0 || out < 0 || fstat(in, &st) || !S_ISREG(st.st_mode)) return;
+    for (dp = sfdisc(op, (Sfdisc_t *)op); dp; dp = dp->disc) {
+        if (dp->writef || dp->seekf) return;
+    }
+    if ((beg = sfseek(ip, (Sfoff_t)0, SEEK_CUR)) < 0 || beg >= st.st_size) return;
+
+    /*
+     * everything already written to op or any stream sharing its pool
+     * must reach the descriptor before the kernel appends to it
+     */
+
+    if ((hp = sfpool(NULL, op, 0)) && hp != op && sfsync(hp)) return;
+    if (sfsync(op)) return;
+    off = (off_t)beg;
+    while ((n = st.st_size - off) > 0) {
+        if (n > SSIZE_MAX) n = SSIZE_MAX;
+        r = -1;
+#if _lib_copy_file_range
+        if (how == 0 && (r = copy_file_range(in, &off, out, NULL, n, 0)) < 0) how = 1;
+#else
+        how = 1;
+#endif
+#if _lib_sendfile
+        if (how == 1 && (r = sendfile(out, in, &off, n)) < 0) how = 2;
+#endif
+        if (r <= 0) break;
+    }
+    if (off > beg) {
+        sfseek(ip, (Sfoff_t)off, SEEK_SET);
+        sfseek(op, (Sfoff_t)0, SEEK_CUR | SF_PUBLIC);
+    }
+#else
+    UNUSED(ip);
+    UNUSED(op);
+#endif
+}
+
 int b_cat(int argc, char **argv, Shbltin_t *context) {
     int n, flag;
     int flags = 0;
@@ -460,10 +522,9 @@ int b_cat(int argc, char **argv, Shbltin_t *context) {
         if (flags & U_FLAG) sfsetbuf(fp, fp, -1);
         if (dovcat) {
             n = vcat(states, fp, sfstdout, flags);
-        } else if (sfmove(fp, sfstdout, SF_UNBOUND, -1) >= 0 && sfeof(fp)) {
-            n = 0;
         } else {
-            n = -1;
+            if (!(flags & (D_FLAG | d_FLAG)) && !mode[1]) fastcat(fp, sfstdout);
+            n = sfmove(fp, sfstdout, SF_UNBOUND, -1) >= 0 && sfeof(fp) ? 0 : -1;
         }
         if (fp != sfstdin) sfclose(fp);
         if (n < 0 && !ERROR_PIPE(errno) && errno != EINTR) {
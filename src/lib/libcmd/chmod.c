@@ -42,7 +42,7 @@
 #include "shcmd.h"
 
 static const char usage[] =
-    "[-?\n@(#)$Id: chmod (AT&T Research) 2012-04-20 $\n]" USAGE_LICENSE
+    "[-c?\n@(#)$Id: chmod (AT&T Research) 2012-04-20 $\n]" USAGE_LICENSE
     "[+NAME?chmod - change the access permissions of files]"
     "[+DESCRIPTION?\bchmod\b changes the permission of each file "
     "according to mode, which can be either a symbolic representation "
@@ -43,7 +43,7 @@
 #include "shcmd.h"
 
 static const char usage[] =
-    "[-?\n@(#)$Id: cmp (AT&T Research) 2010-04-11 $\n]" USAGE_LICENSE
+    "[-c?\n@(#)$Id: cmp (AT&T Research) 2010-04-11 $\n]" USAGE_LICENSE
     "[+NAME?cmp - compare two files]"
     "[+DESCRIPTION?\bcmp\b compares two files \afile1\a and \afile2\a. "
     "\bcmp\b writes no output if the files are the same. By default, if the "
@@ -29,6 +29,8 @@
 #include <ctype.h>
 #include <limits.h>
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 #include <wchar.h>
@@ -41,7 +43,7 @@
 #include "stk.h"
 
 static const char usage[] =
-    "[-?\n@(#)$Id: cut (AT&T Research) 2010-08-11 $\n]" USAGE_LICENSE
+    "[-c?\n@(#)$Id: cut (AT&T Research) 2010-08-11 $\n]" USAGE_LICENSE
     "[+NAME?cut - cut out selected columns or fields of each line of a file]"
     "[+DESCRIPTION?\bcut\b bytes, characters, or character-delimited fields "
     "from one or more files, contatenating them on standard output.]"
@@ -120,6 +122,12 @@ typedef struct Cut_s {
 #define SP_WORD 2
 #define SP_WIDE 3
 
+#define CUT_ONES ((uint64_t)0x0101010101010101)
+#define CUT_HIGH (CUT_ONES * 0x80)
+
+/* non-zero if any byte of w is zero */
+#define cut_zero(w) (((w) - CUT_ONES) & ~(w) & CUT_HIGH)
+
 /*
  * compare the first of an array of integers
  */
@@ -335,6 +343,26 @@ static void cutcols(Cut_t *cut, Sfio_t *fdin, Sfio_t *fdout) {
     }
 }
 
+/*
+ * return the first field or line delimiter at or after cp
+ * single byte locales only; *ep must be the line delimiter so the scan
+ * stops, and no more than ep is read a word at a time
+ */
+
+static unsigned char *cutscan(Cut_t *cut, unsigned char *cp, unsigned char *ep) {
+    uint64_t wm = CUT_ONES * (unsigned char)(cut->wdelim.len == 1 ? cut->wdelim.chr : cut->eob);
+    uint64_t lm = CUT_ONES * (unsigned char)cut->eob;
+    uint64_t w;
+
+    while (ep - cp >= (ptrdiff_t)sizeof(w)) {
+        memcpy(&w, cp, sizeof(w));
+        if (cut_zero(w ^ wm) || cut_zero(w ^ lm)) break;
+        cp += sizeof(w);
+    }
+    while (!cut->space[*cp]) cp++;
+    return cp;
+}
+
 /*
  * cut each line of file <fdin> and put results to <fdout> using list <list>
  * stream <fdin> must be line buffered
@@ -459,10 +487,14 @@ static void cutfields(Cut_t *cut, Sfio_t *fdin, Sfio_t *fdout) {
                         }
                     }
                 } else {
-                    while (!(c = sp[*cp++])) {
-                        ;
+                    /* an open range or the gap after the last range ends with the line */
+                    if (*lp >= HUGE - 1 && !nodelim) {
+                        cp = memchr(cp, cut->eob, ep - cp + 1);
+                    } else {
+                        cp = cutscan(cut, cp, ep);
                     }
-                    wp = cp - 1;
+                    wp = cp;
+                    c = sp[*cp++];
                 }
                 /* check for end-of-line */
                 if (c == SP_LINE) {
@@ -39,7 +39,7 @@
 #include "shcmd.h"
 
 static const char usage[] =
-    "[-?\n@(#)$Id: dirname (AT&T Research) 2009-01-31 $\n]" USAGE_LICENSE
+    "[-c?\n@(#)$Id: dirname (AT&T Research) 2009-01-31 $\n]" USAGE_LICENSE
     "[+NAME?dirname - return directory portion of file name]"
     "[+DESCRIPTION?\bdirname\b treats \astring\a as a file name and returns "
     "the name of the directory containing the file name by deleting "
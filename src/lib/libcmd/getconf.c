@@ -37,7 +37,7 @@
 #include "shcmd.h"
 
 static const char usage[] =
-    "[-?\n@(#)$Id: getconf (AT&T Research) 2013-12-01 $\n]" USAGE_LICENSE
+    "[-c?\n@(#)$Id: getconf (AT&T Research) 2013-12-01 $\n]" USAGE_LICENSE
     "[+NAME?getconf - get configuration values]"
     "[+DESCRIPTION?\bgetconf\b displays the system configuration value for "
     "\aname\a. If \aname\a is a filesystem specific variable then the value "
@@ -37,7 +37,7 @@
 #include "shcmd.h"
 
 static const char usage[] =
-    "[-n?\n@(#)$Id: head (AT&T Research) 2013-09-19 $\n]" USAGE_LICENSE
+    "[-nc?\n@(#)$Id: head (AT&T Research) 2013-09-19 $\n]" USAGE_LICENSE
     "[+NAME?head - output beginning portion of one or more files ]"
     "[+DESCRIPTION?\bhead\b copies one or more input files to standard "
     "output stopping at a designated point for each file or to the end of "
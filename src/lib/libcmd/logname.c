@@ -35,7 +35,7 @@
 #include "sfio.h"
 #include "shcmd.h"
 
-static const char usage[] = "[-?\n@(#)$Id: logname (AT&T Research) 1999-04-30 $\n]" USAGE_LICENSE
+static const char usage[] = "[-c?\n@(#)$Id: logname (AT&T Research) 1999-04-30 $\n]" USAGE_LICENSE
                             "[+NAME?logname - return the user's login name]"
                             "[+DESCRIPTION?\blogname\b writes the users's login name to standard "
                             "output.  The login name is the string that is returned by the "
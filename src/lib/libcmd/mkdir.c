@@ -37,7 +37,7 @@
 #include "option.h"
 #include "shcmd.h"
 
-static const char usage[] = "[-?\n@(#)$Id: mkdir (AT&T Research) 2010-04-08 $\n]" USAGE_LICENSE
+static const char usage[] = "[-c?\n@(#)$Id: mkdir (AT&T Research) 2010-04-08 $\n]" USAGE_LICENSE
                             "[+NAME?mkdir - make directories]"
                             "[+DESCRIPTION?\bmkdir\b creates one or more directories.  By "
                             "default, the mode of created directories is \ba=rwx\b minus the "
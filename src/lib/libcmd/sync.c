@@ -32,7 +32,7 @@
 #include "shcmd.h"
 
 static const char usage[] =
-    "[-?\n@(#)$Id: sync (AT&T Research) 2013-09-22 $\n]" USAGE_LICENSE
+    "[-c?\n@(#)$Id: sync (AT&T Research) 2013-09-22 $\n]" USAGE_LICENSE
     "[+NAME?sync - schedule file/file system updates]"
     "[+DESCRIPTION?\bsync\b(1) transfers buffered modifications of file "
     "metadata and data to the storage device for a specific file, a specific "
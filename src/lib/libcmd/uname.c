@@ -42,7 +42,7 @@
 #include "shcmd.h"
 
 static const char usage[] =
-    "[-?\n@(#)$Id: uname (AT&T Research) 2007-04-19 $\n]" USAGE_LICENSE
+    "[-c?\n@(#)$Id: uname (AT&T Research) 2007-04-19 $\n]" USAGE_LICENSE
     "[+NAME?uname - identify the current system ]"
     "[+DESCRIPTION?By default \buname\b writes the operating system name to"
     "   standard output. When options are specified, one or more"
@@ -38,7 +38,7 @@
 #include "wc.h"
 
 static const char usage[] =
-    "[-?\n@(#)$Id: wc (AT&T Research) 2009-11-28 $\n]" USAGE_LICENSE
+    "[-c?\n@(#)$Id: wc (AT&T Research) 2009-11-28 $\n]" USAGE_LICENSE
     "[+NAME?wc - print the number of bytes, words, and lines in files]"
     "[+DESCRIPTION?\bwc\b reads one or more input files and, by default, "
     "for each file writes a line containing the number of newlines, "
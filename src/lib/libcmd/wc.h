@@ -50,6 +50,7 @@ typedef struct {
     Sfoff_t longest;
     int mode;
     int mb;
+    int ascii;  // only ASCII white space separates words
     Mbstate_t q;
 } Wc_t;
 
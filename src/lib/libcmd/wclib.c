@@ -28,6 +28,7 @@
 
 #include <ctype.h>
 #include <limits.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 #include <sys/types.h>
@@ -50,6 +51,109 @@
 #define mbc(c) ((c)&WC_MB)
 #define spc(c) ((c)&WC_SP)
 
+/*
+ * the counting kernels look at 8 bytes at a time
+ * each byte of a mask has its high bit set if that byte matches
+ */
+
+#define WC_ONES ((uint64_t)0x0101010101010101)
+#define WC_HIGH (WC_ONES * 0x80)
+#define WC_LOW (WC_ONES * 0x7f)
+#define WC_EVEN ((uint64_t)0x00ff00ff00ff00ff)
+
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define wc_prev(m, p) (((m) >> 8) | ((uint64_t)(p) << 63))
+#define wc_last(m) (((m) >> 7) & 1)
+#else
+#define wc_prev(m, p) (((m) << 8) | ((uint64_t)(p) << 7))
+#define wc_last(m) ((m) >> 63)
+#endif
+
+/*
+ * return the mask of bytes in w equal to c
+ */
+
+static uint64_t wc_eq(uint64_t w, int c) {
+    uint64_t z = w ^ (WC_ONES * c);
+    return ~(((z & WC_LOW) + WC_LOW) | z) & WC_HIGH;
+}
+
+/*
+ * return the mask of ASCII white space bytes in w
+ */
+
+static uint64_t wc_space(uint64_t w) {
+    uint64_t l = w & WC_LOW;
+    uint64_t m = (l + WC_ONES * (0x80 - '\t')) & ~(l + WC_ONES * (0x80 - '\r' - 1));
+    return (m & ~w & WC_HIGH) | wc_eq(w, ' ');
+}
+
+/*
+ * return the number of bytes set in mask m
+ */
+
+static int wc_bits(uint64_t m) { return (int)(((m >> 7) * WC_ONES) >> 56); }
+
+/*
+ * return the number of new-lines in the n bytes at cp
+ */
+
+static Sfoff_t wc_lines(const unsigned char *cp, size_t n) {
+    Sfoff_t nlines = 0;
+    uint64_t w;
+    uint64_t sum;
+    int i;
+
+    while (n >= 8) {
+        /* each byte of sum counts up to 255 new-lines */
+        for (sum = 0, i = 0; i < 255 && n >= 8; i++, cp += 8, n -= 8) {
+            memcpy(&w, cp, 8);
+            sum += wc_eq(w, '\n') >> 7;
+        }
+        sum = (sum & WC_EVEN) + ((sum >> 8) & WC_EVEN);
+        nlines += (sum * 0x0001000100010001) >> 48;
+    }
+    while (n-- > 0) {
+        if (*cp++ == '\n') nlines++;
+    }
+    return nlines;
+}
+
+/*
+ * count the words and new-lines in the n bytes at cp for locales whose
+ * white space characters are the ASCII ones
+ * *space is non-zero if the byte before cp was white space and is updated
+ */
+
+static void wc_words(Wc_t *wp, const unsigned char *cp, size_t n, int *space, Sfoff_t *nwords,
+                     Sfoff_t *nlines) {
+    Sfoff_t words = 0;
+    Sfoff_t lines = 0;
+    uint64_t w;
+    uint64_t m;
+    int last = *space != 0;
+
+    for (; n >= 8; cp += 8, n -= 8) {
+        memcpy(&w, cp, 8);
+        m = wc_space(w);
+        words += wc_bits(~m & wc_prev(m, last) & WC_HIGH);
+        last = (int)wc_last(m);
+        lines += wc_bits(wc_eq(w, '\n'));
+    }
+    for (; n > 0; n--, cp++) {
+        if (wp->type[*cp]) {
+            last = 1;
+            if (*cp == '\n') lines++;
+        } else {
+            if (last) words++;
+            last = 0;
+        }
+    }
+    *space = last;
+    *nwords += words;
+    *nlines += lines;
+}
+
 Wc_t *wc_init(int mode) {
     int n;
     int w;
@@ -85,6 +189,10 @@ Wc_t *wc_init(int mode) {
         wp->type[0xfe] = WC_MB | WC_ERR;
         wp->type[0xff] = WC_MB | WC_ERR;
     }
+    wp->ascii = !wp->mb && w;
+    for (n = (1 << CHAR_BIT); --n >= 0;) {
+        if (!wp->type[n] != !(n == ' ' || (n >= '\t' && n <= '\r'))) wp->ascii = 0;
+    }
     wp->mode = mode;
     return wp;
 }
@@ -221,18 +329,13 @@ int wc_count(Wc_t *wp, Sfio_t *fd, const char *file) {
         if (!(wp->mode & (WC_MBYTE | WC_WORDS | WC_LONGEST))) {
             while ((cp = (unsigned char *)sfreserve(fd, SF_UNBOUND, 0)) && (c = sfvalue(fd)) > 0) {
                 nchars += c;
-                endbuff = cp + c;
-                if (*--endbuff == '\n') {
-                    nlines++;
-                } else {
-                    *endbuff = '\n';
-                }
-                for (;;) {
-                    if (*cp++ == '\n') {
-                        if (cp > endbuff) break;
-                        nlines++;
-                    }
-                }
+                nlines += wc_lines(cp, c);
+            }
+        } else if (wp->ascii && !(wp->mode & WC_MBYTE)) {
+            int space = 1;
+            while ((cp = (unsigned char *)sfreserve(fd, SF_UNBOUND, 0)) && (c = sfvalue(fd)) > 0) {
+                nchars += c;
+                wc_words(wp, cp, c, &space, &nwords, &nlines);
             }
         } else {
             while ((cp = buff = (unsigned char *)sfreserve(fd, SF_UNBOUND, 0)) &&